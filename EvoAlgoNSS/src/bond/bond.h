@@ -84,21 +84,47 @@ namespace bond
         *  \return The yield-to-maturity of the bond
         */
         template<typename S> T compute_yield(const T& i_price, const S& solver, const DF_type& df_type) const;
-        /** \fn compute_yield(const T& i_price, const S& solver, const DF_type& df_type, const std::string& bonds_identifier) const
+        /** \fn compute_yield(const T& i_price, const S& solver, const DF_type& df_type, std::string_view bonds_identifier, const std::uint64_t& seed, std::ostream& output) const
         *  \brief Calculates the yield-to-maturity using the supplied solver and passes the bond identifier to the solver
         *  \param i_price The price of the bond
         *  \param solver The parameter structure of the solver that is going to be used to estimate the yield of maturity
         *  \param df_type The type of discount factor method
         *  \param bonds_identifier An identifier for the bond in std::string form
+        *  \param seed The seed of the random number engine of the solver
+        *  \param output The stream the results of the solver are printed to
         *  \return The yield-to-maturity of the bond
         */
-        template<typename S> T compute_yield(const T& i_price, const S& solver, const DF_type& df_type, std::string_view bonds_identifier) const;
+        template<typename S> T compute_yield(const T& i_price, const S& solver, const DF_type& df_type, std::string_view bonds_identifier, const std::uint64_t& seed,
+            std::ostream& output = std::cout) const;
         /** \fn compute_macaulay_duration(const DF_type& df_type)
         *  \brief Calculates the Macaulay duration of the bond
         *  \param df_type The type of discount factor method
         *  \return The Macaulay Duration of the bond
         */
         T compute_macaulay_duration(const DF_type& df_type) const;
+        /** \fn compute_macaulay_duration(const T& r, const DF_type& df_type)
+        *  \brief Calculates the Macaulay duration of the bond for a given yield-to-maturity
+        *  \param r The yield-to-maturity
+        *  \param df_type The type of discount factor method
+        *  \return The Macaulay Duration of the bond
+        */
+        T compute_macaulay_duration(const T& r, const DF_type& df_type) const;
+        /** \fn get_price() const
+        *  \return The price of the bond
+        */
+        const T& get_price() const { return price; }
+        /** \fn get_nominal_value() const
+        *  \return The nominal value of the bond
+        */
+        const T& get_nominal_value() const { return nominal_value; }
+        /** \fn get_cash_flows() const
+        *  \return The coupon payments of the bond
+        */
+        const std::vector<T>& get_cash_flows() const { return cash_flows; }
+        /** \fn get_time_periods() const
+        *  \return The periods of the coupon payments in years
+        */
+        const std::vector<T>& get_time_periods() const { return time_periods; }
     private:
         /** \brief Bond's annual coupon rate */
         const T coupon_percentage;
@@ -150,22 +176,29 @@ namespace bond
     T Bond<T>::compute_yield(const T& i_price, const S& solver, const DF_type& df_type) const
     {
         assert(solver.ndv == 1);
-        const auto f = [&, use_penalty_method = solver.use_penalty_method](const auto& solution) { return fitness_irr(solution, i_price, nominal_value, cash_flows, time_periods, df_type, use_penalty_method); };
+        //! The residual signature is used by the Root solver, the evolutionary solvers use the fitness
+        const auto f = overloaded{
+            [&, use_penalty_method = solver.use_penalty_method](std::span<const T> solution) { return fitness_irr(solution, i_price, nominal_value, cash_flows, time_periods, df_type, use_penalty_method); },
+            [&](const T& r) { return residual_irr(r, i_price, nominal_value, cash_flows, time_periods, df_type); } };
         const auto c = [&, constraints_type = solver.constraints_type](const auto& solution) { return constraints_irr(solution, constraints_type); };
-        auto res = solve(f, c, solver, "YTM");
+        auto res = solve<1>(f, c, solver, "YTM").min_cost;
         T yield = res[0];
         return yield;
     }
 
     template<std::floating_point T>
     template<typename S>
-    T Bond<T>::compute_yield(const T& i_price, const S& solver, const DF_type& df_type, std::string_view bonds_identifier) const
+    T Bond<T>::compute_yield(const T& i_price, const S& solver, const DF_type& df_type, std::string_view bonds_identifier, const std::uint64_t& seed,
+        std::ostream& output) const
     {
         assert(solver.ndv == 1);
-        const auto f = [&, use_penalty_method = solver.use_penalty_method](const auto& solution) { return fitness_irr(solution, i_price, nominal_value, cash_flows, time_periods, df_type, use_penalty_method); };
+        //! The residual signature is used by the Root solver, the evolutionary solvers use the fitness
+        const auto f = overloaded{
+            [&, use_penalty_method = solver.use_penalty_method](std::span<const T> solution) { return fitness_irr(solution, i_price, nominal_value, cash_flows, time_periods, df_type, use_penalty_method); },
+            [&](const T& r) { return residual_irr(r, i_price, nominal_value, cash_flows, time_periods, df_type); } };
         const auto c = [&, constraints_type = solver.constraints_type](const auto& solution) { return constraints_irr(solution, constraints_type); };
         std::string problem = "YTM";
-        auto res = solve(f, c, solver, problem.append(bonds_identifier));
+        auto res = solve<1>(f, c, solver, problem.append(bonds_identifier), seed, output).min_cost;
         T yield = res[0];
         return yield;
     }
@@ -173,7 +206,13 @@ namespace bond
     template<std::floating_point T>
     T Bond<T>::compute_macaulay_duration(const DF_type& df_type) const
     {
-        assert(yield > 0 && yield < 1);
+        return compute_macaulay_duration(yield, df_type);
+    }
+
+    template<std::floating_point T>
+    T Bond<T>::compute_macaulay_duration(const T& r, const DF_type& df_type) const
+    {
+        assert(r > 0 && r < 1);
         assert(cash_flows.size() > 0);
         assert(nominal_value > 0);
         assert(frequency > 0);
@@ -187,7 +226,7 @@ namespace bond
         T numerator = 0.0;
         for (size_t i = 0; i < time_periods.size(); ++i)
         {
-            discount_factor = compute_discount_factor(yield, time_periods[i], df_type);
+            discount_factor = compute_discount_factor(r, time_periods[i], df_type);
             pv = coupon_value * discount_factor;
             numerator = numerator + pv * time_periods[i];
             denominator = denominator + pv;
@@ -6,8 +6,11 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <tuple>
 #include <limits>
+#include <algorithm>
+#include <sstream>
 #include "bond.h"
 #include "../model/svensson.h"
 #include "../model/yield_curve_fitting.h"
@@ -52,6 +55,10 @@ namespace bond
 
     /*! \class BondHelper
     *  \brief A class for the bond pricing problem as well as finding the yield-to-maturities of bonds
+    *  \details Bonds with the same coupon frequency share their coupon dates, so the coupon dates of all bonds are merged into one sorted
+    *  grid without duplicates at construction. The cash flows are stored as a sparse matrix from the bonds to the grid in compressed row form,
+    *  with the nominal value added to the last coupon. A fitness evaluation computes the discount factors once per grid point and prices
+    *  every bond with a sparse dot product. The discount factors and estimated prices are written to buffers that every thread reuses.
     */
     template<std::floating_point T>
     class BondHelper
@@ -65,73 +72,170 @@ namespace bond
         */
         BondHelper(const std::vector<Bond<T>>& i_bonds, const DF_type& i_df_type) :
             bonds(i_bonds),
-            df_type(i_df_type)
-        {};
-        /** \fn set_init_nss_params(const S& solver)
+            df_type(i_df_type),
+            weights(i_bonds.size(), 0)
+        {
+            for (const auto& p : bonds)
+            {
+                grid.insert(grid.end(), p.time_periods.begin(), p.time_periods.end());
+            }
+            std::sort(grid.begin(), grid.end());
+            grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+            cash_flow_offsets.push_back(0);
+            for (const auto& p : bonds)
+            {
+                for (size_t i = 0; i < p.time_periods.size(); ++i)
+                {
+                    const auto column = std::lower_bound(grid.begin(), grid.end(), p.time_periods[i]) - grid.begin();
+                    cash_flow_columns.push_back(static_cast<size_t>(column));
+                    cash_flow_values.push_back(i + 1 < p.time_periods.size() ? p.cash_flows[i] : p.cash_flows[i] + p.nominal_value);
+                }
+                cash_flow_offsets.push_back(cash_flow_columns.size());
+            }
+        };
+        /** \fn set_init_nss_params(const S& solver, const size_t& nthreads)
         *  \brief This method sets the nss initial svensson parameters by computing the bond yields-to-maturity and Macaulay durations
+        *  \details With more than one thread the bonds are processed concurrently. Every bond is solved with its own random stream and its log
+        *  is buffered and printed in the order of the bonds, so the output and the decision variables are identical to a sequential run.
+        *  The solver must then be safe to run concurrently, which holds for the solvers of this project.
         *  \param solver The parameter structure of the solver that is going to be used
+        *  \param nthreads The number of threads that process the bonds
         *  \return A vector of decision variables for NSS
         */
-        template<typename S> std::vector<T> set_init_nss_params(const S& solver);
-        /** \fn bond_pricing(const S1& solver, const S2& solver_irr, const Bond_pricing_type& bond_pricing_type)
+        template<typename S> std::vector<T> set_init_nss_params(const S& solver, const size_t& nthreads = 1);
+        /** \fn bond_pricing(const S& solver, const Bond_pricing_type& bond_pricing_type)
         *  \brief This methods solves the bond pricing problem using prices or yields and the supplied solver
+        *  \details The fitness function of Bond_pricing_type::bpy inverts the estimated prices with compute_irr. Both fitness functions have a batch signature
         *  \param solver The parameter structure of the solver that is going to be used for bond pricing
-        *  \param solver_irr The parameter structure of the solver that is going to be used to estimate the yield of maturity
         *  \param bond_pricing_type Whether to use bond yields-to-maturities or bond prices to find the NSS parameters
         *  \return void
         */
-        template<typename S1, typename S2> void bond_pricing(const S1& solver, const S2& solver_irr, const Bond_pricing_type& bond_pricing_type);
-        /** \fn print_bond_pricing_results(const std::vector<T>& res, const S& solver_irr)
-        *  \brief This method prints to screen the bond pricing results
+        template<typename S> void bond_pricing(const S& solver, const Bond_pricing_type& bond_pricing_type);
+        /** \fn print_bond_pricing_results(const std::vector<T>& res)
+        *  \brief This method prints to screen the estimated and actual prices of the bonds and the mean squared error of the prices
         *  \param res The solution vector of NSS parameters
-        *  \param solver_irr The parameter structure of the solver that is going to be used to estimate the yield of maturity
         *  \return void
         */
-        template<typename S> void print_bond_pricing_results(const std::vector<T>& res, const S& solver_irr);
-    private:
-        /** \brief Vector of bonds */
-        std::vector<Bond<T>> bonds;
-        /** \brief Discount Factor type */
-        const DF_type df_type;
-        /** \fn estimate_bond_pricing(const std::vector<T>& solution, const T& coupon_value, const T& nominal_value, const std::vector<T>& time_periods)
-        *  \brief Returns the bond prices using the estimated spot interest rates computed with svensson
+        void print_bond_pricing_results(const std::vector<T>& res);
+        /** \fn fitness_bond_pricing_prices(std::span<const T> solution, const bool& use_penalty_method)
+        *  \brief This is the fitness function for bond pricing using the bonds' prices
         *  \param solution NSS parameters candindate solution
-        *  \param coupon_value The value of the coupon payment
-        *  \param nominal_value The nominal value of the investment
-        *  \param time_periods The time periods that correspond to the coupon payments
-        *  \return The price of the bond
+        *  \param use_penalty_method Whether to use the penalty method defined for NSS or not
+        *  \return The fitness cost of NSS for bond pricing
+        */
+        T fitness_bond_pricing_prices(std::span<const T> solution, const bool& use_penalty_method);
+        /** \fn fitness_bond_pricing_prices(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method)
+        *  \brief Batch version of the fitness function for bond pricing using the bonds' prices,
+        *  gives the same costs as evaluating every candidate separately within the tolerance of the vectorised svensson
+        *  \param candidates NSS parameters of the candidate solutions, stored row-major
+        *  \param costs The fitness costs of the candidates, overwritten by this method
+        *  \param use_penalty_method Whether to use the penalty method defined for NSS or not
+        *  \return void
         */
-        T estimate_bond_pricing(const std::vector<T>& solution, const T& coupon_value, const T& nominal_value, const std::vector<T>& time_periods);
-        /** \fn fitness_bond_pricing_yields(const std::vector<T>& solution, const S& solver_irr, const bool& use_penalty_method)
+        void fitness_bond_pricing_prices(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method);
+        /** \fn fitness_bond_pricing_yields(std::span<const T> solution, const bool& use_penalty_method)
         *  \brief This is the fitness function for bond pricing using the bonds' yields-to-maturity
+        *  \details The yields of the estimated prices are found by compute_irr, starting from the spot interest rate of the candidate at the Macaulay
+        *  duration of every bond. The starting values depend only on the candidate, so the cost does not depend on the order of the evaluations.
         *  \param solution NSS parameters candindate solution
-        *  \param solver_irr The parameter structure of the solver that is going to be used to estimate the yield of maturity
         *  \param use_penalty_method Whether to use the penalty method defined for NSS or not
         *  \return The fitness cost of NSS for bond pricing
         */
-        template<typename S> T fitness_bond_pricing_yields(const std::vector<T>& solution, const S& solver_irr, const bool& use_penalty_method);
-        /** \fn fitness_bond_pricing_prices(const std::vector<T>& solution, const bool& use_penalty_method)
-        *  \brief This is the fitness function for bond pricing using the bonds' prices
-        *  \param solution NSS parameters candindate solution
+        T fitness_bond_pricing_yields(std::span<const T> solution, const bool& use_penalty_method);
+        /** \fn fitness_bond_pricing_yields(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method)
+        *  \brief Batch version of the fitness function for bond pricing using the bonds' yields-to-maturity,
+        *  gives the same costs as evaluating every candidate separately within the tolerance of the vectorised svensson
+        *  \param candidates NSS parameters of the candidate solutions, stored row-major
+        *  \param costs The fitness costs of the candidates, overwritten by this method
         *  \param use_penalty_method Whether to use the penalty method defined for NSS or not
-        *  \return The fitness cost of NSS for bond pricing
+        *  \return void
+        */
+        void fitness_bond_pricing_yields(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method);
+    private:
+        /** \brief Vector of bonds */
+        std::vector<Bond<T>> bonds;
+        /** \brief Discount Factor type */
+        const DF_type df_type;
+        /** \brief Sorted coupon dates of all bonds without duplicates */
+        std::vector<T> grid;
+        /** \brief The cash flows of bond i are the entries cash_flow_offsets[i] to cash_flow_offsets[i + 1] - 1 of cash_flow_columns and cash_flow_values */
+        std::vector<size_t> cash_flow_offsets;
+        /** \brief Index in grid of every cash flow */
+        std::vector<size_t> cash_flow_columns;
+        /** \brief Value of every cash flow, the last one of a bond includes its nominal value */
+        std::vector<T> cash_flow_values;
+        /** \brief 1 / sqrt(duration) of every bond, the weights of the price errors, set with the durations by set_init_nss_params */
+        std::vector<T> weights;
+        /** \struct Scratch
+        *  \brief Buffers of the fitness functions, reused from one evaluation to the next so that an evaluation does not allocate
+        */
+        struct Scratch
+        {
+            /** \brief Discount factors at the grid points, of one candidate or of a batch stored grid point by grid point */
+            std::vector<T> factors;
+            /** \brief Estimated prices of all bonds for one candidate, or of one bond for the candidates of a batch */
+            std::vector<T> estimates;
+            /** \brief Spot interest rates of the candidates of a batch at the duration of a bond */
+            std::vector<T> rates;
+            /** \brief Parameters of the candidates of a batch */
+            Svensson_batch<T> batch;
+        };
+        /** \fn scratch()
+        *  \brief The buffers of the calling thread, every thread has its own since the solvers may evaluate candidates concurrently
+        *  \return A reference to the buffers of the calling thread
+        */
+        static Scratch& scratch()
+        {
+            thread_local Scratch buffers;
+            return buffers;
+        }
+        /** \fn estimate_bond_prices(std::span<const T> solution, std::span<T> prices)
+        *  \brief Computes the prices of all bonds using the estimated spot interest rates computed with svensson
+        *  \param solution NSS parameters candindate solution
+        *  \param prices The prices of the bonds, overwritten by this method
+        *  \return void
+        */
+        void estimate_bond_prices(std::span<const T> solution, std::span<T> prices);
+        /** \fn batch_discount_factors(const Svensson_batch<T>& batch, std::vector<T>& factors)
+        *  \brief Computes the discount factors of a batch of candidate solutions at every grid point
+        *  \param batch The parameters of the candidate solutions
+        *  \param factors The discount factors, resized and overwritten grid point by grid point
+        *  \return void
         */
-        T fitness_bond_pricing_prices(const std::vector<T>& solution, const bool& use_penalty_method);
+        void batch_discount_factors(const Svensson_batch<T>& batch, std::vector<T>& factors);
+        /** \fn estimate_bond_price(const size_t& i, std::span<const T> factors, std::span<T> prices)
+        *  \brief Computes the price of a bond for every candidate solution of a batch
+        *  \param i The index of the bond
+        *  \param factors The discount factors of the batch computed by batch_discount_factors
+        *  \param prices The prices of the bond for the candidates, overwritten by this method
+        *  \return void
+        */
+        void estimate_bond_price(const size_t& i, std::span<const T> factors, std::span<T> prices);
     };
 
     template<std::floating_point T>
     template<typename S>
-    std::vector<T> BondHelper<T>::set_init_nss_params(const S& solver)
+    std::vector<T> BondHelper<T>::set_init_nss_params(const S& solver, const size_t& nthreads)
     {
-        for (size_t i = 0; i < bonds.size(); ++i)
+        //! Every bond writes to its own log, the logs are printed in order once all bonds are processed
+        std::vector<std::stringstream> logs(bonds.size());
+        Thread_pool pool{ nthreads };
+        pool.parallel_for(bonds.size(), [&](const size_t& i)
+            {
+                std::stringstream& log = logs[i];
+                log << "Processing bond: " << i + 1 << "\n";
+                //! Every bond is solved with its own random stream derived from the seed of the solver
+                bonds[i].yield = bonds[i].compute_yield(bonds[i].price, solver, df_type, std::to_string(i + 1), derive_seed(solver.seed, i), log);
+                bonds[i].duration = bonds[i].compute_macaulay_duration(df_type);
+                weights[i] = 1 / std::sqrt(bonds[i].duration);
+                log << "Yield to Maturity: " << bonds[i].yield << "\n";
+                log << "Macaulay Duration: " << bonds[i].duration << "\n";
+                log << "Estimated Price: " << compute_pv(bonds[i].yield, bonds[i].nominal_value, bonds[i].cash_flows, bonds[i].time_periods, df_type)
+                    << " Actual Price: " << bonds[i].price << "\n";
+            });
+        for (const auto& p : logs)
         {
-            std::cout << "Processing bond: " << i + 1 << "\n";
-            bonds[i].yield = bonds[i].compute_yield(bonds[i].price, solver, df_type, std::to_string(i + 1));
-            bonds[i].duration = bonds[i].compute_macaulay_duration(df_type);
-            std::cout << "Yield to Maturity: " << bonds[i].yield << "\n";
-            std::cout << "Macaulay Duration: " << bonds[i].duration << "\n";
-            std::cout << "Estimated Price: " << compute_pv(bonds[i].yield, bonds[i].nominal_value, bonds[i].cash_flows, bonds[i].time_periods, df_type)
-                << " Actual Price: " << bonds[i].price << "\n";
+            std::cout << p.str();
         }
         size_t minimum_index = 0;
         size_t maximum_index = 0;
@@ -175,28 +279,64 @@ namespace bond
     }
 
     template<std::floating_point T>
-    T BondHelper<T>::estimate_bond_pricing(const std::vector<T>& solution, const T& coupon_value, const T& nominal_value, const std::vector<T>& time_periods)
+    void BondHelper<T>::estimate_bond_prices(std::span<const T> solution, std::span<T> prices)
     {
-        T sum = 0.0;
-        //! Call svensson for period
-        for (const auto& t : time_periods)
+        assert(prices.size() == bonds.size());
+        //! The discount factors are computed once per grid point by the vectorised svensson
+        std::vector<T>& factors = scratch().factors;
+        factors.resize(grid.size());
+        svensson_discount_factors<T>(solution, grid, df_type, factors);
+        for (size_t i = 0; i < bonds.size(); ++i)
         {
-            sum = sum + coupon_value * compute_discount_factor(svensson(solution, t), t, df_type);
+            T sum = 0.0;
+            for (size_t j = cash_flow_offsets[i]; j < cash_flow_offsets[i + 1]; ++j)
+            {
+                sum = sum + cash_flow_values[j] * factors[cash_flow_columns[j]];
+            }
+            prices[i] = sum;
         }
-        T m = time_periods.back();
-        sum = sum + nominal_value * compute_discount_factor(svensson(solution, m), m, df_type);
-        return sum;
     }
 
     template<std::floating_point T>
-    T BondHelper<T>::fitness_bond_pricing_prices(const std::vector<T>& solution, const bool& use_penalty_method)
+    void BondHelper<T>::batch_discount_factors(const Svensson_batch<T>& batch, std::vector<T>& factors)
     {
-        //! The sum of squares of errors between the actual bond price and the estimated price from estimate_bond_pricing
+        //! The discount factors of all candidates are computed once per grid point and stored grid point by grid point
+        const size_t n = batch.size;
+        factors.resize(grid.size() * n);
+        for (size_t g = 0; g < grid.size(); ++g)
+        {
+            svensson_discount_factors<T>(batch, grid[g], df_type, std::span<T>(factors).subspan(g * n, n));
+        }
+    }
+
+    template<std::floating_point T>
+    void BondHelper<T>::estimate_bond_price(const size_t& i, std::span<const T> factors, std::span<T> prices)
+    {
+        const size_t n = prices.size();
+        assert(factors.size() == grid.size() * n);
+        std::fill(prices.begin(), prices.end(), T(0));
+        for (size_t j = cash_flow_offsets[i]; j < cash_flow_offsets[i + 1]; ++j)
+        {
+            const T value = cash_flow_values[j];
+            const T* column = &factors[cash_flow_columns[j] * n];
+            for (size_t k = 0; k < n; ++k)
+            {
+                prices[k] = prices[k] + value * column[k];
+            }
+        }
+    }
+
+    template<std::floating_point T>
+    T BondHelper<T>::fitness_bond_pricing_prices(std::span<const T> solution, const bool& use_penalty_method)
+    {
+        //! The sum of squares of errors between the actual bond price and the estimated price from estimate_bond_prices
+        std::vector<T>& estimates = scratch().estimates;
+        estimates.resize(bonds.size());
+        estimate_bond_prices(solution, estimates);
         T sum_of_squares = 0.0;
-        for (const auto& k : bonds)
+        for (size_t i = 0; i < bonds.size(); ++i)
         {
-            T estimate = estimate_bond_pricing(solution, k.coupon_value, k.nominal_value, k.time_periods);
-            sum_of_squares = sum_of_squares + std::pow((k.price / 100 - estimate / 100), 2) / std::sqrt(k.duration);
+            sum_of_squares = sum_of_squares + std::pow((bonds[i].price / 100 - estimates[i] / 100), 2) * weights[i];
         }
         if (use_penalty_method)
         {
@@ -209,15 +349,47 @@ namespace bond
     }
 
     template<std::floating_point T>
-    template<typename S>
-    T BondHelper<T>::fitness_bond_pricing_yields(const std::vector<T>& solution, const S& solver_irr, const bool& use_penalty_method)
+    void BondHelper<T>::fitness_bond_pricing_prices(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method)
+    {
+        Svensson_batch<T>& batch = scratch().batch;
+        batch.assign(candidates);
+        std::vector<T>& factors = scratch().factors;
+        batch_discount_factors(batch, factors);
+        const size_t n = costs.size();
+        std::vector<T>& estimates = scratch().estimates;
+        estimates.resize(n);
+        std::fill(costs.begin(), costs.end(), T(0));
+        for (size_t i = 0; i < bonds.size(); ++i)
+        {
+            estimate_bond_price(i, factors, estimates);
+            for (size_t k = 0; k < n; ++k)
+            {
+                costs[k] = costs[k] + std::pow((bonds[i].price / 100 - estimates[k] / 100), 2) * weights[i];
+            }
+        }
+        if (use_penalty_method)
+        {
+            for (size_t k = 0; k < n; ++k)
+            {
+                costs[k] = costs[k] + penalty_svensson(candidates.subspan(6 * k, 6));
+            }
+        }
+    }
+
+    template<std::floating_point T>
+    T BondHelper<T>::fitness_bond_pricing_yields(std::span<const T> solution, const bool& use_penalty_method)
     {
         //! The sum of squares of errors between the actual bond yield to maturity and the estimated yield to maturity by svensson is used
+        std::vector<T>& estimate_prices = scratch().estimates;
+        estimate_prices.resize(bonds.size());
+        estimate_bond_prices(solution, estimate_prices);
         T sum_of_squares = 0;
-        for (const auto& k : bonds)
+        for (size_t i = 0; i < bonds.size(); ++i)
         {
-            T estimate_price = estimate_bond_pricing(solution, k.coupon_value, k.nominal_value, k.time_periods);
-            T estimate = k.compute_yield(estimate_price, solver_irr, df_type);
+            const auto& k = bonds[i];
+            const T& estimate_price = estimate_prices[i];
+            //! The yield of a bond is close to the spot interest rate at its duration, a good starting value for Newton's method
+            const T estimate = compute_irr(estimate_price, k.nominal_value, k.cash_flows, k.time_periods, df_type, svensson<T>(solution, k.duration));
             sum_of_squares = sum_of_squares + std::pow(k.yield - estimate, 2);
         }
         if (use_penalty_method)
@@ -231,8 +403,41 @@ namespace bond
     }
 
     template<std::floating_point T>
-    template<typename S1, typename S2>
-    void BondHelper<T>::bond_pricing(const S1& solver, const S2& solver_irr, const Bond_pricing_type& bond_pricing_type)
+    void BondHelper<T>::fitness_bond_pricing_yields(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method)
+    {
+        Svensson_batch<T>& batch = scratch().batch;
+        batch.assign(candidates);
+        std::vector<T>& factors = scratch().factors;
+        batch_discount_factors(batch, factors);
+        const size_t n = costs.size();
+        std::vector<T>& estimates = scratch().estimates;
+        std::vector<T>& rates = scratch().rates;
+        estimates.resize(n);
+        rates.resize(n);
+        std::fill(costs.begin(), costs.end(), T(0));
+        for (size_t i = 0; i < bonds.size(); ++i)
+        {
+            const auto& p = bonds[i];
+            estimate_bond_price(i, factors, estimates);
+            svensson<T>(batch, p.duration, rates);
+            for (size_t k = 0; k < n; ++k)
+            {
+                const T estimate = compute_irr(estimates[k], p.nominal_value, p.cash_flows, p.time_periods, df_type, rates[k]);
+                costs[k] = costs[k] + std::pow(p.yield - estimate, 2);
+            }
+        }
+        if (use_penalty_method)
+        {
+            for (size_t k = 0; k < n; ++k)
+            {
+                costs[k] = costs[k] + penalty_svensson(candidates.subspan(6 * k, 6));
+            }
+        }
+    }
+
+    template<std::floating_point T>
+    template<typename S>
+    void BondHelper<T>::bond_pricing(const S& solver, const Bond_pricing_type& bond_pricing_type)
     {
         assert(solver.ndv == 6);
         for (const auto& p : bonds)
@@ -244,42 +449,39 @@ namespace bond
         {
         case(Bond_pricing_type::bpp):
         {
-            const auto f = [&, use_penalty_method = solver.use_penalty_method](const auto& solution) { return fitness_bond_pricing_prices(solution, use_penalty_method); };
+            //! The solvers use the batch signature to evaluate whole generations
+            const auto f = overloaded{
+                [&, use_penalty_method = solver.use_penalty_method](std::span<const T> solution) { return fitness_bond_pricing_prices(solution, use_penalty_method); },
+                [&, use_penalty_method = solver.use_penalty_method](std::span<const T> candidates, std::span<T> costs) { fitness_bond_pricing_prices(candidates, costs, use_penalty_method); } };
             const auto c = [&, constraints_type = solver.constraints_type](const auto& solution) { return constraints_svensson(solution, constraints_type); };
             std::cout << "Solving bond pricing using bond prices..." << "\n";
-            auto res = solve(f, c, solver, "BPP");
-            print_bond_pricing_results(res, solver_irr);
+            auto res = solve<6>(f, c, solver, "BPP").min_cost;
+            print_bond_pricing_results(res);
             break;
         }
         case(Bond_pricing_type::bpy):
         {
-            const auto f = [&, use_penalty_method = solver.use_penalty_method](const auto& solution) { return fitness_bond_pricing_yields(solution, solver_irr, use_penalty_method); };
+            const auto f = overloaded{
+                [&, use_penalty_method = solver.use_penalty_method](std::span<const T> solution) { return fitness_bond_pricing_yields(solution, use_penalty_method); },
+                [&, use_penalty_method = solver.use_penalty_method](std::span<const T> candidates, std::span<T> costs) { fitness_bond_pricing_yields(candidates, costs, use_penalty_method); } };
             const auto c = [&, constraints_type = solver.constraints_type](const auto& solution) { return constraints_svensson(solution, constraints_type); };
             std::cout << "Solving bond pricing using bond yields..." << "\n";
-            auto res = solve(f, c, solver, "BPY");
-            print_bond_pricing_results(res, solver_irr);
+            auto res = solve<6>(f, c, solver, "BPY").min_cost;
+            print_bond_pricing_results(res);
         }
         }
     }
 
     template<std::floating_point T>
-    template<typename S>
-    void BondHelper<T>::print_bond_pricing_results(const std::vector<T>& res, const S& solver_irr)
+    void BondHelper<T>::print_bond_pricing_results(const std::vector<T>& res)
     {
         T error = 0;
-        //for (const auto& p : bonds)
-        //{
-            //T estimate_price = estimate_bond_pricing(res, p.coupon_value, p.nominal_value, p.time_periods);
-            //T estimate = p.compute_yield(estimate_price, solver_irr, df_type);
-            //error = error + std::pow(estimate - p.yield, 2);
-            //std::cout << "Estimated yield: " << estimate << " Actual Yield: " << p.yield << "\n";
-        //}
-        //std::cout << "Yield Mean Squared Error: " << error << "\n";
-        error = 0;
-        for (const auto& p : bonds)
+        std::vector<T> estimates(bonds.size());
+        estimate_bond_prices(res, estimates);
+        for (size_t i = 0; i < bonds.size(); ++i)
         {
-            error = error + std::pow(estimate_bond_pricing(res, p.coupon_value, p.nominal_value, p.time_periods) / 100 - p.price / 100, 2);
-            std::cout << "Estimated price: " << estimate_bond_pricing(res, p.coupon_value, p.nominal_value, p.time_periods) << " Actual Price: " << p.price << "\n";
+            error = error + std::pow(estimates[i] / 100 - bonds[i].price / 100, 2);
+            std::cout << "Estimated price: " << estimates[i] << " Actual Price: " << bonds[i].price << "\n";
         }
         std::cout << "Price Mean Squared Error: " << error / static_cast<T>(bonds.size()) << "\n";
     }
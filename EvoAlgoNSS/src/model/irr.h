@@ -6,7 +6,12 @@
 #pragma once
 
 #include <vector>
+#include <span>
 #include <cmath>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <assert.h>
 #include "../utilities.h"
 
 using namespace utilities;
@@ -32,14 +37,14 @@ namespace irr
         }
     }
 
-    /** \fn constraints_irr(const std::vector<T>& solution, const Constraints_type& constraints_type)
+    /** \fn constraints_irr(std::span<const T> solution, const Constraints_type& constraints_type)
     *  \brief Constraints function for Internal Rate of Return
     *  \param solution Internal Rate of Return candindate solution
     *  \param constraints_type Type of constraints used
     *  \return True if constraints are satisfied, false otherwise
     */
     template<std::floating_point T>
-    bool constraints_irr(const std::vector<T>& solution, const Constraints_type& constraints_type)
+    bool constraints_irr(std::span<const T> solution, const Constraints_type& constraints_type)
     {
         switch (constraints_type)
         {
@@ -83,6 +88,99 @@ namespace irr
         return sum + nominal_value * compute_discount_factor(r, time_periods.back(), df_type);
     }
 
+    /** \fn compute_pv_and_derivative(const T& r, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods, const DF_type& df_type)
+    *  \brief Returns the present value of an investment and its derivative with respect to the rate, in one pass over the cash flows
+    *  \details The derivative of the discount factor at period t is -t * DF / (1 + r) for DF_type::frac and -t * DF for DF_type::exp
+    *  \param r Internal Rate of Return
+    *  \param nominal_value The nominal value of the investment
+    *  \param cash_flows The cash flows of the investment
+    *  \param time_periods The time periods that correspond to the cash flows of the investment
+    *  \param df_type The method used to calculate the discount factor
+    *  \return The present value of the investment and its derivative
+    */
+    template<std::floating_point T>
+    std::pair<T, T> compute_pv_and_derivative(const T& r, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods, const DF_type& df_type)
+    {
+        assert(cash_flows.size() == time_periods.size());
+        const T rate_factor = df_type == DF_type::frac ? 1 / (1 + r) : 1;
+        T pv = 0.0;
+        T derivative = 0.0;
+        T discount_factor = 0.0;
+        for (size_t i = 0; i < time_periods.size(); ++i)
+        {
+            discount_factor = compute_discount_factor(r, time_periods[i], df_type);
+            pv = pv + cash_flows[i] * discount_factor;
+            derivative = derivative - cash_flows[i] * time_periods[i] * discount_factor * rate_factor;
+        }
+        pv = pv + nominal_value * discount_factor;
+        derivative = derivative - nominal_value * time_periods.back() * discount_factor * rate_factor;
+        return { pv, derivative };
+    }
+
+    /** \fn residual_irr(const T& r, const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods, const DF_type& df_type)
+    *  \brief The residual of the internal rate of return equation, whose root is the internal rate of return, and its derivative
+    *  \param r Internal Rate of Return candidate
+    *  \param price The present value of the investment
+    *  \param nominal_value The nominal value of the investment
+    *  \param cash_flows The cash flows of the investment
+    *  \param time_periods The time periods that correspond to the cash flows of the investment
+    *  \param df_type The method used to calculate the discount factor
+    *  \return The difference between the present value at rate r and the price, and its derivative with respect to r
+    */
+    template<std::floating_point T>
+    std::pair<T, T> residual_irr(const T& r, const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods, const DF_type& df_type)
+    {
+        const auto [pv, derivative] = compute_pv_and_derivative(r, nominal_value, cash_flows, time_periods, df_type);
+        return { pv - price, derivative };
+    }
+
+    /** \fn compute_irr(const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods, const DF_type& df_type,
+        const T& guess, const size_t& iter_max = 50)
+    *  \brief Internal rate of return by Newton's method with the analytic derivative, for repeated inversions of prices with a good starting value
+    *  \details Newton's method is applied to log(PV(r) / price). With positive cash flows it is a convex decreasing function of the rate that is close
+    *  to a straight line, so the iterations converge monotonically after the first step and in a few steps even far from the root, where the
+    *  present value itself is flat. A step that makes the present value undefined (1 + r <= 0 for DF_type::frac) or not finite is halved until it
+    *  does not. The iterations stop when a step is below a few units in the last place of the rate.
+    *  \param price The present value of the investment, it must be positive
+    *  \param nominal_value The nominal value of the investment
+    *  \param cash_flows The cash flows of the investment
+    *  \param time_periods The time periods that correspond to the cash flows of the investment
+    *  \param df_type The method used to calculate the discount factor
+    *  \param guess The starting value, for example the rate found for a nearby price
+    *  \param iter_max The maximum number of iterations
+    *  \return The internal rate of return, NaN if the price is not positive
+    */
+    template<std::floating_point T>
+    T compute_irr(const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods, const DF_type& df_type,
+        const T& guess, const size_t& iter_max = 50)
+    {
+        if (!(price > 0))
+        {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+        const T tol = 16 * std::numeric_limits<T>::epsilon();
+        T r = guess;
+        for (size_t iter = 0; iter < iter_max; ++iter)
+        {
+            const auto [pv, derivative] = compute_pv_and_derivative(r, nominal_value, cash_flows, time_periods, df_type);
+            T step = std::log(pv / price) / (derivative / pv);
+            if (!std::isfinite(step))
+            {
+                break;
+            }
+            while ((df_type == DF_type::frac && r - step <= -1) || !std::isfinite(r - step))
+            {
+                step = step / 2;
+            }
+            r = r - step;
+            if (std::abs(step) <= tol * std::max(std::abs(r), T(1)))
+            {
+                break;
+            }
+        }
+        return r;
+    }
+
     /** \fn penalty_irr(const T& r)
     *  \brief Penalty function for IRR
     *  \param r Candidate solution for the Internal Rate of Return
@@ -100,7 +198,7 @@ namespace irr
         return sum;
     }
 
-    /** \fn fitness_irr(const std::vector<T>& solution, const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods,
+    /** \fn fitness_irr(std::span<const T> solution, const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods,
         const DF_type& df_type, const bool& use_penalty_method)
     *  \brief This is the fitness function for finding the internal rate of return of a bond, in this case it is equal to its yield to maturity
     *  \param solution Internal Rate of Return candindate solution
@@ -113,7 +211,7 @@ namespace irr
     *  \return The fitness cost of IRR
     */
     template<std::floating_point T>
-    T fitness_irr(const std::vector<T>& solution, const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods,
+    T fitness_irr(std::span<const T> solution, const T& price, const T& nominal_value, const std::vector<T>& cash_flows, const std::vector<T>& time_periods,
         const DF_type& df_type, const bool& use_penalty_method)
     {
         T sum_of_squares = 0;
@@ -5,17 +5,25 @@
 
 #pragma once
 
+#include <span>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include "irr.h"
+#include "../simd.h"
+
 //! Nelson-Siegel-Svensson (NSS) model namespace
 namespace nss
 {
-    /** \fn constraints_svensson(const std::vector<T>& solution, const Constraints_type& constraints_type)
+    /** \fn constraints_svensson(std::span<const T> solution, const Constraints_type& constraints_type)
     *  \brief Constraints function for the NSS model
     *  \param solution NSS parameters candindate solution
     *  \param constraints_type Type of constraints used
     *  \return True if constraints are satisfied, false otherwise
     */
     template<std::floating_point T>
-    bool constraints_svensson(const std::vector<T>& solution, const Constraints_type& constraints_type)
+    bool constraints_svensson(std::span<const T> solution, const Constraints_type& constraints_type)
     {
         switch (constraints_type)
         {
@@ -61,14 +69,14 @@ namespace nss
         }
     }
 
-    /** \fn svensson(const std::vector<T>& solution, const T& m)
+    /** \fn svensson(std::span<const T> solution, const T& m)
     *  \brief Spot interest rate at term m using the NSS model
     *  \param solution Candidate solution for the parameters of NSS
     *  \param m The term at which the spot interest rate is recorded
     *  \return The spot interest rate at term m
     */
     template<std::floating_point T>
-    T svensson(const std::vector<T>& solution, const T& m)
+    T svensson(std::span<const T> solution, const T& m)
     {
         const T& b0 = solution[0];
         const T& b1 = solution[1];
@@ -90,13 +98,360 @@ namespace nss
         }
     }
 
-    /** \fn penalty_svensson(const std::vector<T>& solution)
+    /** \struct Svensson_batch
+    *  \brief The parameters of a batch of NSS candidate solutions, stored as one array per parameter
+    *  \details The candidates arrive row-major from the solvers. Storing them transposed makes the loop over the candidates at a fixed term
+    *  a loop over contiguous arrays without branches, which is evaluated one SIMD pack at a time.
+    */
+    template<std::floating_point T>
+    struct Svensson_batch
+    {
+        /** \fn Svensson_batch()
+        *  \brief Default constructor, an empty batch whose arrays are filled by assign
+        *  \return A Svensson_batch<T> object
+        */
+        Svensson_batch() = default;
+        /** \fn Svensson_batch(std::span<const T> candidates)
+        *  \brief Constructor
+        *  \param candidates NSS parameters of the candidate solutions, stored row-major
+        *  \return A Svensson_batch<T> object
+        */
+        explicit Svensson_batch(std::span<const T> candidates)
+        {
+            assign(candidates);
+        }
+        /** \fn assign(std::span<const T> candidates)
+        *  \brief Replaces the candidate solutions of the batch, the arrays only allocate when the batch is larger than any before
+        *  \param candidates NSS parameters of the candidate solutions, stored row-major
+        *  \return void
+        */
+        void assign(std::span<const T> candidates)
+        {
+            size = candidates.size() / 6;
+            assert(candidates.size() == 6 * size);
+            b0.assign(padded_size(), 0);
+            b1.assign(padded_size(), 0);
+            b2.assign(padded_size(), 0);
+            b3.assign(padded_size(), 0);
+            tau1.assign(padded_size(), 1);
+            tau2.assign(padded_size(), 1);
+            for (size_t k = 0; k < size; ++k)
+            {
+                b0[k] = candidates[6 * k];
+                b1[k] = candidates[6 * k + 1];
+                b2[k] = candidates[6 * k + 2];
+                b3[k] = candidates[6 * k + 3];
+                tau1[k] = candidates[6 * k + 4];
+                tau2[k] = candidates[6 * k + 5];
+            }
+        }
+        /** \brief Number of candidate solutions */
+        size_t size = 0;
+        /** \brief Parameters of the candidate solutions, padded with harmless values up to a whole number of SIMD packs */
+        std::vector<T> b0, b1, b2, b3, tau1, tau2;
+    private:
+        /** \fn padded_size() const
+        *  \brief Size of the parameter arrays
+        *  \return The number of candidates rounded up to a whole number of SIMD packs
+        */
+        size_t padded_size() const
+        {
+            return (size + simd::width - 1) / simd::width * simd::width;
+        }
+    };
+
+    /** \fn svensson_kernel(const P& m, const P& b0, const P& b1, const P& b2, const P& b3, const P& tau1, const P& tau2)
+    *  \brief The NSS model for a non-zero term, written once for scalars and for SIMD packs
+    *  \details The operations are those of svensson(solution, m) in the same order, so the scalar instantiation gives identical results
+    *  and the SIMD instantiations differ only by the accuracy of simd::exp. The SIMD rates are within 1e-14 * (|b0| + |b1| + |b2| + |b3|)
+    *  of the scalar rates (an absolute tolerance, since the rate itself can be close to zero after cancellation) and the discount factors
+    *  exp(-r * m) computed from them are within a relative tolerance of m times that bound.
+    *  \param m The term
+    *  \param b0,b1,b2,b3,tau1,tau2 The parameters of NSS
+    *  \return The spot interest rate at term m
+    */
+    template<typename P>
+    P svensson_kernel(const P& m, const P& b0, const P& b1, const P& b2, const P& b3, const P& tau1, const P& tau2)
+    {
+        using std::exp;
+        const P x1 = m / tau1;
+        const P x2 = m / tau2;
+        const P e1 = exp(-x1);
+        const P e2 = exp(-x2);
+        const P g1 = (1 - e1) / x1;
+        const P g2 = (1 - e2) / x2;
+        P result = b0 + b1 * g1;
+        result = result + b2 * (g1 - e1);
+        result = result + b3 * (g2 - e2);
+        return result;
+    }
+
+    /** \fn svensson_kernel(const P& m, const P& inverse_m, const P& b0, const P& b1, const P& b2, const P& b3, const P& tau1, const P& tau2, const P& inverse_tau1, const P& inverse_tau2)
+    *  \brief The NSS model for a non-zero term, using the precomputed inverses of the term and of tau1 and tau2
+    *  \details The divisions of svensson_kernel are replaced by multiplications, so the rates differ from svensson(solution, m) by a few
+    *  units in the last place in addition to the tolerance given in svensson_kernel
+    *  \param m The term
+    *  \param inverse_m 1 / m
+    *  \param b0,b1,b2,b3,tau1,tau2 The parameters of NSS
+    *  \param inverse_tau1,inverse_tau2 1 / tau1 and 1 / tau2
+    *  \return The spot interest rate at term m
+    */
+    template<typename P>
+    P svensson_kernel(const P& m, const P& inverse_m, const P& b0, const P& b1, const P& b2, const P& b3, const P& tau1, const P& tau2,
+        const P& inverse_tau1, const P& inverse_tau2)
+    {
+        using std::exp;
+        const P e1 = exp(-(m * inverse_tau1));
+        const P e2 = exp(-(m * inverse_tau2));
+        const P g1 = (1 - e1) * tau1 * inverse_m;
+        const P g2 = (1 - e2) * tau2 * inverse_m;
+        P result = b0 + b1 * g1;
+        result = result + b2 * (g1 - e1);
+        result = result + b3 * (g2 - e2);
+        return result;
+    }
+
+    /** \fn svensson_sum_of_squares(std::span<const T> solution, std::span<const T> maturities, std::span<const T> inverse_maturities, std::span<const T> rates)
+    *  \brief Sum of the squared differences between recorded spot interest rates and the rates of the NSS model, in one pass over the terms
+    *  \details For double the terms are processed one SIMD pack at a time and the squares are accumulated in a pack that is summed at the end
+    *  \param solution Candidate solution for the parameters of NSS
+    *  \param maturities The terms, all of them non-zero
+    *  \param inverse_maturities The inverses of the terms
+    *  \param rates The recorded spot interest rates at the terms
+    *  \return The sum of squares of the errors
+    */
+    template<std::floating_point T>
+    T svensson_sum_of_squares(std::span<const T> solution, std::span<const T> maturities, std::span<const T> inverse_maturities, std::span<const T> rates)
+    {
+        assert(maturities.size() == inverse_maturities.size() && maturities.size() == rates.size());
+        const T& b0 = solution[0];
+        const T& b1 = solution[1];
+        const T& b2 = solution[2];
+        const T& b3 = solution[3];
+        const T& tau1 = solution[4];
+        const T& tau2 = solution[5];
+        const T inverse_tau1 = 1 / tau1;
+        const T inverse_tau2 = 1 / tau2;
+        T sum_of_squares = 0;
+        size_t i = 0;
+        if constexpr (std::is_same_v<T, double>)
+        {
+            using simd::Pack;
+            Pack squares{ 0.0 };
+            for (; i + simd::width <= maturities.size(); i += simd::width)
+            {
+                const Pack estimate = svensson_kernel(simd::load(&maturities[i]), simd::load(&inverse_maturities[i]), Pack(b0), Pack(b1), Pack(b2),
+                    Pack(b3), Pack(tau1), Pack(tau2), Pack(inverse_tau1), Pack(inverse_tau2));
+                const Pack error = simd::load(&rates[i]) - estimate;
+                squares = simd::fma(error, error, squares);
+            }
+            sum_of_squares = simd::reduce_add(squares);
+        }
+        for (; i < maturities.size(); ++i)
+        {
+            const T error = rates[i] - svensson_kernel(maturities[i], inverse_maturities[i], b0, b1, b2, b3, tau1, tau2, inverse_tau1, inverse_tau2);
+            sum_of_squares = sum_of_squares + error * error;
+        }
+        return sum_of_squares;
+    }
+
+    /** \fn svensson(std::span<const T> solution, std::span<const T> maturities, std::span<T> rates)
+    *  \brief Spot interest rates at an array of terms using the NSS model
+    *  \details For double the terms are processed one SIMD pack at a time (see simd.h) and the rates match svensson(solution, m)
+    *  within the tolerance given in svensson_kernel. Other floating-point types use svensson(solution, m) for every term.
+    *  \param solution Candidate solution for the parameters of NSS
+    *  \param maturities The terms
+    *  \param rates The spot interest rates at the terms, overwritten by this function
+    *  \return void
+    */
+    template<std::floating_point T>
+    void svensson(std::span<const T> solution, std::span<const T> maturities, std::span<T> rates)
+    {
+        assert(maturities.size() == rates.size());
+        if constexpr (std::is_same_v<T, double>)
+        {
+            using simd::Pack;
+            const Pack b0{ solution[0] }, b1{ solution[1] }, b2{ solution[2] }, b3{ solution[3] }, tau1{ solution[4] }, tau2{ solution[5] };
+            simd::transform(maturities, rates, [&](const Pack& m)
+                {
+                    return simd::select_if_zero(m, b0 + b1, svensson_kernel(m, b0, b1, b2, b3, tau1, tau2));
+                });
+        }
+        else
+        {
+            for (size_t i = 0; i < maturities.size(); ++i)
+            {
+                rates[i] = svensson(solution, maturities[i]);
+            }
+        }
+    }
+
+    /** \fn svensson_discount_factors(std::span<const T> solution, std::span<const T> maturities, const DF_type& df_type, std::span<T> factors)
+    *  \brief Discount factors at an array of terms using the spot interest rates of the NSS model
+    *  \details With DF_type::exp and double the discount factors are computed in the same SIMD pass as the rates, with the tolerance of
+    *  svensson(solution, maturities, rates). Otherwise the rates are computed first and compute_discount_factor is applied to each one.
+    *  \param solution Candidate solution for the parameters of NSS
+    *  \param maturities The terms
+    *  \param df_type The method used to calculate the discount factor
+    *  \param factors The discount factors at the terms, overwritten by this function
+    *  \return void
+    */
+    template<std::floating_point T>
+    void svensson_discount_factors(std::span<const T> solution, std::span<const T> maturities, const DF_type& df_type, std::span<T> factors)
+    {
+        if constexpr (std::is_same_v<T, double>)
+        {
+            if (df_type == DF_type::exp)
+            {
+                using simd::Pack;
+                const Pack b0{ solution[0] }, b1{ solution[1] }, b2{ solution[2] }, b3{ solution[3] }, tau1{ solution[4] }, tau2{ solution[5] };
+                simd::transform(maturities, factors, [&](const Pack& m)
+                    {
+                        using std::exp;
+                        const Pack r = simd::select_if_zero(m, b0 + b1, svensson_kernel(m, b0, b1, b2, b3, tau1, tau2));
+                        return exp(-(r * m));
+                    });
+                return;
+            }
+        }
+        svensson(solution, maturities, factors);
+        for (size_t i = 0; i < maturities.size(); ++i)
+        {
+            factors[i] = irr::compute_discount_factor(factors[i], maturities[i], df_type);
+        }
+    }
+
+    /** \fn svensson(const Svensson_batch<T>& batch, const T& m, std::span<T> rates)
+    *  \brief Spot interest rates at term m for a batch of candidate solutions using the NSS model
+    *  \details For double the candidates are processed one SIMD pack at a time and the rates match svensson(solution, m) within the tolerance
+    *  given in svensson_kernel, other floating-point types give the same results as svensson(solution, m)
+    *  \param batch The parameters of the candidate solutions
+    *  \param m The term at which the spot interest rate is recorded
+    *  \param rates The spot interest rates of the candidates, overwritten by this function
+    *  \return void
+    */
+    template<std::floating_point T>
+    void svensson(const Svensson_batch<T>& batch, const T& m, std::span<T> rates)
+    {
+        assert(rates.size() == batch.size);
+        if (m == 0)
+        {
+            for (size_t k = 0; k < batch.size; ++k)
+            {
+                rates[k] = batch.b0[k] + batch.b1[k];
+            }
+            return;
+        }
+        if constexpr (std::is_same_v<T, double>)
+        {
+            //! The arrays of the batch are padded to whole packs
+            using simd::Pack;
+            const Pack term{ m };
+            std::array<double, simd::width> buffer;
+            for (size_t k = 0; k < batch.size; k += simd::width)
+            {
+                const Pack result = svensson_kernel(term, simd::load(&batch.b0[k]), simd::load(&batch.b1[k]), simd::load(&batch.b2[k]),
+                    simd::load(&batch.b3[k]), simd::load(&batch.tau1[k]), simd::load(&batch.tau2[k]));
+                simd::store(buffer.data(), result);
+                std::copy(buffer.begin(), buffer.begin() + std::min(simd::width, batch.size - k), rates.begin() + k);
+            }
+        }
+        else
+        {
+            for (size_t k = 0; k < batch.size; ++k)
+            {
+                rates[k] = svensson_kernel(m, batch.b0[k], batch.b1[k], batch.b2[k], batch.b3[k], batch.tau1[k], batch.tau2[k]);
+            }
+        }
+    }
+
+    /** \fn svensson_sum_of_squares(const Svensson_batch<T>& batch, std::span<const T> maturities, std::span<const T> inverse_maturities, std::span<const T> rates, std::span<T> costs)
+    *  \brief Sums of squared errors of svensson_sum_of_squares(solution, maturities, inverse_maturities, rates) for a batch of candidate solutions
+    *  \details For double one SIMD pack of candidates is kept in registers while all the terms are visited, so no intermediate rates are stored
+    *  \param batch The parameters of the candidate solutions
+    *  \param maturities The terms, all of them non-zero
+    *  \param inverse_maturities The inverses of the terms
+    *  \param rates The recorded spot interest rates at the terms
+    *  \param costs The sums of squares of the errors of the candidates, overwritten by this function
+    *  \return void
+    */
+    template<std::floating_point T>
+    void svensson_sum_of_squares(const Svensson_batch<T>& batch, std::span<const T> maturities, std::span<const T> inverse_maturities, std::span<const T> rates,
+        std::span<T> costs)
+    {
+        assert(maturities.size() == inverse_maturities.size() && maturities.size() == rates.size());
+        assert(costs.size() == batch.size);
+        if constexpr (std::is_same_v<T, double>)
+        {
+            //! The arrays of the batch are padded to whole packs
+            using simd::Pack;
+            std::array<double, simd::width> buffer;
+            for (size_t k = 0; k < batch.size; k += simd::width)
+            {
+                const Pack b0 = simd::load(&batch.b0[k]), b1 = simd::load(&batch.b1[k]), b2 = simd::load(&batch.b2[k]), b3 = simd::load(&batch.b3[k]);
+                const Pack tau1 = simd::load(&batch.tau1[k]), tau2 = simd::load(&batch.tau2[k]);
+                const Pack inverse_tau1 = Pack(1.0) / tau1, inverse_tau2 = Pack(1.0) / tau2;
+                Pack squares{ 0.0 };
+                for (size_t i = 0; i < maturities.size(); ++i)
+                {
+                    const Pack error = Pack(rates[i]) - svensson_kernel(Pack(maturities[i]), Pack(inverse_maturities[i]), b0, b1, b2, b3, tau1, tau2,
+                        inverse_tau1, inverse_tau2);
+                    squares = simd::fma(error, error, squares);
+                }
+                simd::store(buffer.data(), squares);
+                std::copy(buffer.begin(), buffer.begin() + std::min(simd::width, batch.size - k), costs.begin() + k);
+            }
+        }
+        else
+        {
+            for (size_t k = 0; k < batch.size; ++k)
+            {
+                const std::array<T, 6> solution{ batch.b0[k], batch.b1[k], batch.b2[k], batch.b3[k], batch.tau1[k], batch.tau2[k] };
+                costs[k] = svensson_sum_of_squares<T>(solution, maturities, inverse_maturities, rates);
+            }
+        }
+    }
+
+    /** \fn svensson_discount_factors(const Svensson_batch<T>& batch, const T& m, const DF_type& df_type, std::span<T> factors)
+    *  \brief Discount factors at term m for a batch of candidate solutions using the spot interest rates of the NSS model
+    *  \details With DF_type::exp and double the discount factors are computed one SIMD pack at a time, with the tolerance of svensson(batch, m, rates)
+    *  \param batch The parameters of the candidate solutions
+    *  \param m The term
+    *  \param df_type The method used to calculate the discount factor
+    *  \param factors The discount factors of the candidates, overwritten by this function
+    *  \return void
+    */
+    template<std::floating_point T>
+    void svensson_discount_factors(const Svensson_batch<T>& batch, const T& m, const DF_type& df_type, std::span<T> factors)
+    {
+        svensson(batch, m, factors);
+        if constexpr (std::is_same_v<T, double>)
+        {
+            if (df_type == DF_type::exp)
+            {
+                using simd::Pack;
+                const Pack term{ m };
+                simd::transform(factors, factors, [&](const Pack& r)
+                    {
+                        using std::exp;
+                        return exp(-(r * term));
+                    });
+                return;
+            }
+        }
+        for (auto& p : factors)
+        {
+            p = irr::compute_discount_factor(p, m, df_type);
+        }
+    }
+
+    /** \fn penalty_svensson(std::span<const T> solution)
     *  \brief Penalty function for NSS
     *  \param solution Candidate solution for the parameters of NSS
     *  \return A penalty value, if constraints are not satisfied
     */
     template<std::floating_point T>
-    T penalty_svensson(const std::vector<T>& solution)
+    T penalty_svensson(std::span<const T> solution)
     {
         T sum = 0;
         const T& b0 = solution[0];
@@ -60,6 +60,9 @@ namespace yft {
 
     /*! \class Interest_Rate_Helper
     *  \brief  A class for the yield-curve-fitting problem
+    *  \details The periods and rates are stored as contiguous arrays. The rates recorded at period zero, where NSS reduces to b0 + b1,
+    *  are kept apart from the others, and the inverses of the non-zero periods are computed once in the constructor, so that the fitness
+    *  functions are a single pass over the arrays without branches or divisions by the periods.
     */
     template<std::floating_point T>
     class Interest_Rate_Helper
@@ -70,8 +73,26 @@ namespace yft {
         *  \param i_ir_vec A vector of Interest_Rate<T> objects
         *  \return An Interest_Rate_Helper object
         */
-        Interest_Rate_Helper(const std::vector<Interest_Rate<T>>& i_ir_vec) :
-            ir_vec{ i_ir_vec } {};
+        Interest_Rate_Helper(const std::vector<Interest_Rate<T>>& i_ir_vec)
+        {
+            periods.reserve(i_ir_vec.size());
+            rates.reserve(i_ir_vec.size());
+            for (const auto& p : i_ir_vec)
+            {
+                periods.push_back(p.period);
+                rates.push_back(p.rate);
+                if (p.period == 0)
+                {
+                    zero_period_rates.push_back(p.rate);
+                }
+                else
+                {
+                    terms.push_back(p.period);
+                    inverse_terms.push_back(1 / p.period);
+                    term_rates.push_back(p.rate);
+                }
+            }
+        };
         /** \fn yieldcurve_fitting(const S& solver)
         *  \brief Yield Curve Fitting using interest rates and recorded periods
         *  \param solver The parameter structure of the solver that is going to be used for yield curve fitting
@@ -81,35 +102,37 @@ namespace yft {
         void yieldcurve_fitting(const S& solver)
         {
             assert(solver.ndv == 6);
-            auto f = [&, use_penalty_method = solver.use_penalty_method](const auto& solution) { return fitness_yield_curve_fitting(solution, use_penalty_method); };
+            //! The solvers use the batch signature to evaluate whole generations
+            auto f = overloaded{
+                [&, use_penalty_method = solver.use_penalty_method](std::span<const T> solution) { return fitness_yield_curve_fitting(solution, use_penalty_method); },
+                [&, use_penalty_method = solver.use_penalty_method](std::span<const T> candidates, std::span<T> costs) { fitness_yield_curve_fitting(candidates, costs, use_penalty_method); } };
             auto c = [&, constraints_type = solver.constraints_type](const auto& solution) { return constraints_svensson(solution, constraints_type); };
             std::cout << "Yield Curve fitting." << "\n";
-            auto res = solve(f, c, solver, "YFT");
+            auto res = solve<6>(f, c, solver, "YFT").min_cost;
+            std::vector<T> estimates(periods.size());
+            svensson<T>(res, periods, estimates);
             T error = 0;
-            for (const auto& p : ir_vec)
+            for (size_t i = 0; i < periods.size(); ++i)
             {
-                error = error + std::pow(svensson(res, p.period) - p.rate, 2);
-                //std::cout << "Estimated interest rates: " << svensson(res, p.period) << " Actual interest rates: " << p.rate << "\n";
+                error = error + std::pow(estimates[i] - rates[i], 2);
+                //std::cout << "Estimated interest rates: " << estimates[i] << " Actual interest rates: " << rates[i] << "\n";
             }
-            std::cout << "Zero-rate Mean Squared Error: " << error / static_cast<T>(ir_vec.size()) << "\n";
+            std::cout << "Zero-rate Mean Squared Error: " << error / static_cast<T>(periods.size()) << "\n";
         };
-    private:
-        /** \brief Vector of interest rates */
-        std::vector<Interest_Rate<T>> ir_vec;
-        /** \fn fitness_yield_curve_fitting(const std::vector<T>& solution, const bool& use_penalty_method)
+        /** \fn fitness_yield_curve_fitting(std::span<const T> solution, const bool& use_penalty_method) const
         *  \brief This is the fitness function for yield-curve fitting using Interest Rates
         *  \param solution NSS parameters candindate solution
         *  \param use_penalty_method Whether to use the penalty method defined for NSS or not
         *  \return The fitness cost of NSS for yield curve fitting
         */
-        T fitness_yield_curve_fitting(const std::vector<T>& solution, const bool& use_penalty_method)
+        T fitness_yield_curve_fitting(std::span<const T> solution, const bool& use_penalty_method) const
         {
             //! The sum of squares of errors betwwen the actual rates and the rates computed by svensson are used
-            T sum_of_squares = 0;
-            for (size_t i = 0; i < ir_vec.size(); ++i)
+            const T short_rate = solution[0] + solution[1];
+            T sum_of_squares = svensson_sum_of_squares<T>(solution, terms, inverse_terms, term_rates);
+            for (const auto& p : zero_period_rates)
             {
-                T estimate = svensson(solution, ir_vec[i].period);
-                sum_of_squares = sum_of_squares + std::pow(ir_vec[i].rate - estimate, 2);
+                sum_of_squares = sum_of_squares + (p - short_rate) * (p - short_rate);
             }
             if (use_penalty_method)
             {
@@ -120,5 +143,43 @@ namespace yft {
                 return sum_of_squares;
             }
         };
+        /** \fn fitness_yield_curve_fitting(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method) const
+        *  \brief Batch version of the fitness function for yield-curve fitting, gives the same costs as evaluating every candidate separately
+        *  within the tolerance of the vectorised svensson
+        *  \param candidates NSS parameters of the candidate solutions, stored row-major
+        *  \param costs The fitness costs of the candidates, overwritten by this method
+        *  \param use_penalty_method Whether to use the penalty method defined for NSS or not
+        *  \return void
+        */
+        void fitness_yield_curve_fitting(std::span<const T> candidates, std::span<T> costs, const bool& use_penalty_method) const
+        {
+            const Svensson_batch<T> batch{ candidates };
+            svensson_sum_of_squares<T>(batch, terms, inverse_terms, term_rates, costs);
+            for (size_t k = 0; k < costs.size(); ++k)
+            {
+                const T short_rate = batch.b0[k] + batch.b1[k];
+                for (const auto& p : zero_period_rates)
+                {
+                    costs[k] = costs[k] + (p - short_rate) * (p - short_rate);
+                }
+                if (use_penalty_method)
+                {
+                    costs[k] = costs[k] + penalty_svensson(candidates.subspan(6 * k, 6));
+                }
+            }
+        };
+    private:
+        /** \brief Periods of the interest rates, in the order of the input */
+        std::vector<T> periods;
+        /** \brief Interest rates, in the order of the input */
+        std::vector<T> rates;
+        /** \brief Interest rates recorded at period zero */
+        std::vector<T> zero_period_rates;
+        /** \brief Non-zero periods */
+        std::vector<T> terms;
+        /** \brief Inverses of the non-zero periods */
+        std::vector<T> inverse_terms;
+        /** \brief Interest rates recorded at the non-zero periods */
+        std::vector<T> term_rates;
     };
 }
\ No newline at end of file
@@ -0,0 +1,186 @@
+/** \file simd.h
+* \author Ioannis Anagnostopoulos
+* \brief Packs of double precision numbers and a vectorised exponential, used by the kernels of the models
+* \details The instruction set is chosen at compile time: AVX-512 when __AVX512F__ is defined (8 lanes), AVX2 when __AVX2__ is defined (4 lanes)
+* and a scalar fallback otherwise, in which a Pack is a plain double and every function calls its scalar counterpart from the standard library.
+*
+* The vectorised exponential reduces the argument to r = x - n * ln(2) with |r| <= ln(2) / 2 and evaluates the Taylor polynomial of degree 13 of exp(r),
+* whose truncation error is below 1e-17. Its relative error against std::exp is about one unit in the last place (below 1e-15) for arguments in [-708, 709].
+* Arguments outside of that range are clamped, so that very small results are returned as about 1e-308 instead of zero and very large results
+* as about 1e308 instead of infinity.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <span>
+#include <algorithm>
+#include <assert.h>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#if defined(__GNUC__) && !defined(__clang__)
+//! The AVX-512 intrinsics of some GCC versions initialise their undefined registers from themselves, which -Wuninitialized reports
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+//! SIMD utilities
+namespace simd
+{
+#if defined(__AVX512F__)
+    /** \brief Number of lanes of a Pack */
+    constexpr size_t width = 8;
+    /** \struct Pack
+    *  \brief Eight double precision numbers in an AVX-512 register
+    */
+    struct Pack
+    {
+        Pack() = default;
+        /** \brief Sets all lanes to x */
+        Pack(const double& x) : v{ _mm512_set1_pd(x) } {}
+        explicit Pack(const __m512d& i_v) : v{ i_v } {}
+        __m512d v;
+    };
+    inline Pack load(const double* p) { return Pack{ _mm512_loadu_pd(p) }; }
+    inline void store(double* p, const Pack& a) { _mm512_storeu_pd(p, a.v); }
+    inline Pack operator+(const Pack& a, const Pack& b) { return Pack{ _mm512_add_pd(a.v, b.v) }; }
+    inline Pack operator-(const Pack& a, const Pack& b) { return Pack{ _mm512_sub_pd(a.v, b.v) }; }
+    inline Pack operator*(const Pack& a, const Pack& b) { return Pack{ _mm512_mul_pd(a.v, b.v) }; }
+    inline Pack operator/(const Pack& a, const Pack& b) { return Pack{ _mm512_div_pd(a.v, b.v) }; }
+    inline Pack operator-(const Pack& a) { return Pack{ _mm512_sub_pd(_mm512_setzero_pd(), a.v) }; }
+    inline Pack fma(const Pack& a, const Pack& b, const Pack& c) { return Pack{ _mm512_fmadd_pd(a.v, b.v, c.v) }; }
+    inline Pack min(const Pack& a, const Pack& b) { return Pack{ _mm512_min_pd(a.v, b.v) }; }
+    inline Pack max(const Pack& a, const Pack& b) { return Pack{ _mm512_max_pd(a.v, b.v) }; }
+    inline Pack round(const Pack& a) { return Pack{ _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+    /** \brief 2^n for integral n in [-1022, 1023], by writing n + 1023 to the exponent bits */
+    inline Pack pow2(const Pack& n)
+    {
+        const __m512d shifted = _mm512_add_pd(n.v, _mm512_set1_pd(6755399441055744.0 + 1023));
+        return Pack{ _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(shifted), 52)) };
+    }
+    /** \brief Lanes of if_zero where m is zero, lanes of otherwise elsewhere */
+    inline Pack select_if_zero(const Pack& m, const Pack& if_zero, const Pack& otherwise)
+    {
+        const __mmask8 mask = _mm512_cmp_pd_mask(m.v, _mm512_setzero_pd(), _CMP_EQ_OQ);
+        return Pack{ _mm512_mask_blend_pd(mask, otherwise.v, if_zero.v) };
+    }
+    /** \brief Sum of the lanes of a */
+    inline double reduce_add(const Pack& a) { return _mm512_reduce_add_pd(a.v); }
+#elif defined(__AVX2__)
+    /** \brief Number of lanes of a Pack */
+    constexpr size_t width = 4;
+    /** \struct Pack
+    *  \brief Four double precision numbers in an AVX2 register
+    */
+    struct Pack
+    {
+        Pack() = default;
+        /** \brief Sets all lanes to x */
+        Pack(const double& x) : v{ _mm256_set1_pd(x) } {}
+        explicit Pack(const __m256d& i_v) : v{ i_v } {}
+        __m256d v;
+    };
+    inline Pack load(const double* p) { return Pack{ _mm256_loadu_pd(p) }; }
+    inline void store(double* p, const Pack& a) { _mm256_storeu_pd(p, a.v); }
+    inline Pack operator+(const Pack& a, const Pack& b) { return Pack{ _mm256_add_pd(a.v, b.v) }; }
+    inline Pack operator-(const Pack& a, const Pack& b) { return Pack{ _mm256_sub_pd(a.v, b.v) }; }
+    inline Pack operator*(const Pack& a, const Pack& b) { return Pack{ _mm256_mul_pd(a.v, b.v) }; }
+    inline Pack operator/(const Pack& a, const Pack& b) { return Pack{ _mm256_div_pd(a.v, b.v) }; }
+    inline Pack operator-(const Pack& a) { return Pack{ _mm256_sub_pd(_mm256_setzero_pd(), a.v) }; }
+#if defined(__FMA__) || defined(_MSC_VER)
+    inline Pack fma(const Pack& a, const Pack& b, const Pack& c) { return Pack{ _mm256_fmadd_pd(a.v, b.v, c.v) }; }
+#else
+    inline Pack fma(const Pack& a, const Pack& b, const Pack& c) { return a * b + c; }
+#endif
+    inline Pack min(const Pack& a, const Pack& b) { return Pack{ _mm256_min_pd(a.v, b.v) }; }
+    inline Pack max(const Pack& a, const Pack& b) { return Pack{ _mm256_max_pd(a.v, b.v) }; }
+    inline Pack round(const Pack& a) { return Pack{ _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) }; }
+    /** \brief 2^n for integral n in [-1022, 1023], by writing n + 1023 to the exponent bits */
+    inline Pack pow2(const Pack& n)
+    {
+        const __m256d shifted = _mm256_add_pd(n.v, _mm256_set1_pd(6755399441055744.0 + 1023));
+        return Pack{ _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(shifted), 52)) };
+    }
+    /** \brief Lanes of if_zero where m is zero, lanes of otherwise elsewhere */
+    inline Pack select_if_zero(const Pack& m, const Pack& if_zero, const Pack& otherwise)
+    {
+        return Pack{ _mm256_blendv_pd(otherwise.v, if_zero.v, _mm256_cmp_pd(m.v, _mm256_setzero_pd(), _CMP_EQ_OQ)) };
+    }
+    /** \brief Sum of the lanes of a */
+    inline double reduce_add(const Pack& a)
+    {
+        const __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+    }
+#else
+    /** \brief Number of lanes of a Pack */
+    constexpr size_t width = 1;
+    /** \brief Without SIMD support a Pack is a single double and the scalar functions of the standard library are used */
+    using Pack = double;
+    inline Pack load(const double* p) { return *p; }
+    inline void store(double* p, const Pack& a) { *p = a; }
+    /** \brief if_zero where m is zero, otherwise elsewhere */
+    inline Pack select_if_zero(const Pack& m, const Pack& if_zero, const Pack& otherwise) { return m == 0 ? if_zero : otherwise; }
+    /** \brief a * b + c, rounded twice since a fused multiply-add may not be available in hardware */
+    inline Pack fma(const Pack& a, const Pack& b, const Pack& c) { return a * b + c; }
+    /** \brief Sum of the lanes of a */
+    inline double reduce_add(const Pack& a) { return a; }
+#endif
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+    /** \fn exp(const Pack& x)
+    *  \brief Vectorised exponential, see the description of this file for its accuracy
+    *  \param x The arguments
+    *  \return The exponential of every lane of x
+    */
+    inline Pack exp(const Pack& x)
+    {
+        //! Coefficients 1 / k! of the Taylor polynomial, from k = 13 down to k = 0
+        constexpr std::array<double, 14> coefficients{
+            1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0,
+            1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 1.0 / 2.0, 1.0, 1.0 };
+        const Pack clamped = min(max(x, Pack(-708.0)), Pack(709.0));
+        const Pack n = round(clamped * Pack(1.4426950408889634));
+        //! ln(2) is split in two parts (Cody and Waite), so that the reduced argument is exact
+        Pack r = fma(n, Pack(-6.93145751953125e-1), clamped);
+        r = fma(n, Pack(-1.42860682030941723212e-6), r);
+        Pack p = coefficients[0];
+        for (size_t k = 1; k < coefficients.size(); ++k)
+        {
+            p = fma(p, r, Pack(coefficients[k]));
+        }
+        return p * pow2(n);
+    }
+#endif
+
+    /** \fn transform(std::span<const double> x, std::span<double> y, const Op& op)
+    *  \brief Sets y[i] = op(x[i]) one pack at a time, the last incomplete pack is padded with zeros
+    *  \param x The arguments
+    *  \param y The results, overwritten by this function
+    *  \param op A function that takes and returns a Pack
+    *  \return void
+    */
+    template<typename Op>
+    void transform(std::span<const double> x, std::span<double> y, const Op& op)
+    {
+        assert(x.size() == y.size());
+        size_t i = 0;
+        for (; i + width <= x.size(); i += width)
+        {
+            store(&y[i], op(load(&x[i])));
+        }
+        if (i < x.size())
+        {
+            std::array<double, width> buffer{};
+            std::copy(x.begin() + i, x.end(), buffer.begin());
+            store(buffer.data(), op(load(buffer.data())));
+            std::copy(buffer.begin(), buffer.begin() + (x.size() - i), y.begin() + i);
+        }
+    }
+}
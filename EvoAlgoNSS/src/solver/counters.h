@@ -0,0 +1,94 @@
+/** \file counters.h
+* \author Ioannis Anagnostopoulos
+* \brief Counters of the work done by a solve and the time spent in each of its phases
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /** \struct Counters
+    *  \brief Counts of the operations of a solve and the time spent in each of its phases, in seconds measured with std::chrono::steady_clock
+    *  \details The phases do not overlap. The initial population is sampled and evaluated at construction. During the iterations, evaluation,
+    *  selection and other add up to the elapsed time of the solve:
+    *  - initialisation is the sampling of the initial population and its constraint checks;
+    *  - evaluation is every call of the objective function, including the initial population. Populations and batches are timed once per
+    *    batch, the single evaluations of the asynchronous DE generation and of the root finder once per call;
+    *  - selection is the choice of the individuals that survive or reproduce, the update of the best solution and the migration of islands;
+    *  - other is the rest of the iterations, measured as the elapsed time minus evaluation and selection: mostly the variation operators
+    *    that produce new candidates and their constraint checks, together with the stopping criteria, the trace and the bookkeeping.
+    */
+    struct Counters
+    {
+        /** \brief Objective function evaluations */
+        size_t evaluations = 0;
+        /** \brief Constraints function evaluations */
+        size_t constraint_evaluations = 0;
+        /** \brief Constraints function evaluations that rejected the candidate */
+        size_t constraint_rejections = 0;
+        /** \brief Candidates drawn again because the previous one was rejected: the initial population, the donors of DE and the re-mutations of GA */
+        size_t resamples = 0;
+        /** \brief Time spent initialising the population */
+        double init_time = 0;
+        /** \brief Time spent evaluating the objective function */
+        double evaluation_time = 0;
+        /** \brief Time of the iterations that is not evaluation or selection, mostly variation */
+        double other_time = 0;
+        /** \brief Time spent selecting individuals */
+        double selection_time = 0;
+        /** \fn operator+=(const Counters& other)
+        *  \brief Adds the counts and times of another solve, for example of another island
+        *  \param other The counters that are added
+        *  \return A reference to these counters
+        */
+        Counters& operator+=(const Counters& other)
+        {
+            evaluations += other.evaluations;
+            constraint_evaluations += other.constraint_evaluations;
+            constraint_rejections += other.constraint_rejections;
+            resamples += other.resamples;
+            init_time += other.init_time;
+            evaluation_time += other.evaluation_time;
+            other_time += other.other_time;
+            selection_time += other.selection_time;
+            return *this;
+        }
+    };
+
+    /*! \class Phase_timer
+    *  \brief Adds the time between its construction and its destruction to a total, used to time the phases of a solve
+    */
+    class Phase_timer
+    {
+    public:
+        /** \fn Phase_timer(double& i_total)
+        *  \brief Constructor, starts the timer
+        *  \param i_total The total in seconds the elapsed time is added to
+        *  \return A Phase_timer object
+        */
+        explicit Phase_timer(double& i_total) :
+            total{ i_total },
+            start{ std::chrono::steady_clock::now() }
+        {
+        }
+        Phase_timer(const Phase_timer&) = delete;
+        Phase_timer& operator=(const Phase_timer&) = delete;
+        /** \fn ~Phase_timer()
+        *  \brief Destructor, adds the elapsed time to the total
+        */
+        ~Phase_timer()
+        {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            total += elapsed.count();
+        }
+    private:
+        /** \brief Total the elapsed time is added to */
+        double& total;
+        /** \brief Time of construction */
+        std::chrono::time_point<std::chrono::steady_clock> start;
+    };
+}
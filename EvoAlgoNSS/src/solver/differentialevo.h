@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <array>
 #include "ealgorithm_base.h"
 
 namespace ea
@@ -19,7 +20,9 @@ namespace ea
         /** \fn DE(const T& i_cr, const T& i_f_param, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
             const bool& i_use_penalty_method = false, const Constraints_type& i_constraints_type = Constraints_type::none,
-            const bool& i_print_to_output = true, const bool& i_print_to_file = true)
+            const bool& i_print_to_output = true, const bool& i_print_to_file = true, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {})
         *	\brief Constructor
         *	\param i_cr Crossover Rate
         *	\param i_f_param Mutation Scale Factor
@@ -32,13 +35,21 @@ namespace ea
         *	\param i_constraints_type What kind of constraints to use
         *	\param i_print_to_output Whether to print to terminal or not
         *	\param i_print_to_file Whether to print to a file or not
+        *	\param i_seed The seed of the random number engine of the solver
+        *	\param i_nthreads The number of threads used to evaluate the population, with more than one thread the generations are synchronous, as they are with a batch objective function
+        *	\param i_trace_capacity The number of iterations kept by the convergence trace, 0 disables it
+        *	\param i_time_budget The wall-clock time in seconds the solve may take from the construction of the solver, 0 for no limit
+        *	\param i_cancellation A stop token, the solve stops at the first iteration after a stop is requested on it
+        *	\param i_stopping Additional stopping criteria, all disabled by default
         *	\return A DE<T> object
         */
         DE(const T& i_cr, const T& i_f_param, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
             const bool& i_use_penalty_method, const Constraints_type& i_constraints_type,
-            const bool& i_print_to_output, const bool& i_print_to_file) :
-            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file),
+            const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {}) :
+            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file, i_seed, i_nthreads, i_trace_capacity, i_time_budget, i_cancellation, i_stopping),
             cr(i_cr),
             f_param(i_f_param)
         {
@@ -53,26 +64,30 @@ namespace ea
         std::string_view type = "Differential Evolution";
     };
 
-    /*! \class Solver<DE, T, F, C>
+    /*! \class Solver<DE, T, F, C, N>
     *  \brief Differential Evolution Algorithm (DE) Class
     */
-    template<std::floating_point T, typename F, typename C>
-    class Solver<DE, T, F, C> : public Solver_base<Solver<DE, T, F, C>, DE, T, F, C>
+    template<std::floating_point T, typename F, typename C, size_t N>
+    class Solver<DE, T, F, C, N> : public Solver_base<Solver<DE, T, F, C, N>, DE, T, F, C, N>
     {
     public:
-        friend class Solver_base<Solver<DE, T, F, C>, DE, T, F, C>;
-        /*! \fn Solver(const DE<T>& i_de, const F& f, const C& c)
+        friend class Solver_base<Solver<DE, T, F, C, N>, DE, T, F, C, N>;
+        /*! \fn Solver(const DE<T>& i_de, const F& f, const C& c, const std::uint64_t& seed)
         *  \brief Constructor
         *  \param i_de The differential evolution parameter structure that is used to construct the solver
         *  \param f A reference to the objective function
         *  \param c A reference to the constraints function
-        *  \return A Solver<DE, T, F, C> object
+        *  \param seed The seed of the random number engine
+        *  \return A Solver<DE, T, F, C, N> object
         */
-        Solver(const DE<T>& i_de, const F& f, const C& c) :
-            Solver_base<Solver<DE, T, F, C>, DE, T, F, C>(i_de, f, c),
+        Solver(const DE<T>& i_de, const F& f, const C& c, const std::uint64_t& seed) :
+            Solver_base<Solver<DE, T, F, C, N>, DE, T, F, C, N>(i_de, f, c, seed),
             de(this->solver_struct),
             indices(set_indices()),
-            ind_distribution(std::uniform_int_distribution<size_t>(0, de.npop - 1))
+            ind_distribution(std::uniform_int_distribution<size_t>(0, de.npop - 1)),
+            donor(make_individual<T, N>(de.ndv)),
+            trial(make_individual<T, N>(de.ndv)),
+            trials(de.nthreads > 1 || batch_objective<F, T> ? de.npop : 0, de.ndv)
         {
         };
     private:
@@ -82,18 +97,38 @@ namespace ea
         const std::vector<size_t> indices;
         /** \brief Uniform size_t distribution of the indices */
         std::uniform_int_distribution<size_t> ind_distribution;
-        /** \fn construct_donor()
+        /** \brief Donor vector, reused across generations */
+        Individual<T, N> donor;
+        /** \brief Trial vector, reused across generations */
+        Individual<T, N> trial;
+        /** \brief Trial vectors of a synchronous generation, one per individual */
+        Population<T, N> trials;
+        /** \fn construct_donor(std::span<T, N> donor)
         *  \brief Method that constructs the donor vector
-        *  \return Donor vector
+        *  \param donor The donor vector to be overwritten
+        *  \return void
         */
-        std::vector<T> construct_donor();
-        /** \fn construct_trial()
+        void construct_donor(std::span<T, N> donor);
+        /** \fn construct_trial(std::span<const T, N> target, std::span<const T, N> donor, std::span<T, N> trial)
         *  \brief Method that constructs the trial vector
         *  \param target Target vector (an individual)
         *  \param donor Donor vector produced from construct_donor()
-        *  \result A trial vector that is compared with the current individual
+        *  \param trial The trial vector that is compared with the current individual, overwritten by this method
+        *  \return void
         */
-        std::vector<T> construct_trial(const std::vector<T>& target, const std::vector<T>& donor);
+        void construct_trial(std::span<const T, N> target, std::span<const T, N> donor, std::span<T, N> trial);
+        /** \fn asynchronous_generation()
+        *  \brief Runs a generation in which every trial vector is compared with its target as soon as it is constructed,
+        *  so that later donors of the same generation can use the individuals that have already been replaced
+        *  \return void
+        */
+        void asynchronous_generation();
+        /** \fn synchronous_generation()
+        *  \brief Runs a generation in which all trial vectors are constructed from the current population, evaluated in parallel
+        *  or with one call of a batch objective function, and then compared with their targets
+        *  \return void
+        */
+        void synchronous_generation();
         /** \fn set_indices()
         *  \brief Generate the indices
         *  \return The vector of the population indices
@@ -122,44 +157,46 @@ namespace ea
         *  \brief Runs the algorithm until stopping criteria
         *  return void
         */
-        void run_algo();
+        void run_algo() { this->run_iterations(0, de.iter_max); }
+        /** \fn iterate(const size_t& iter)
+        *  \brief Runs one iteration of the algorithm
+        *  \param iter The iteration
+        *  \return True if the stopping criteria are met
+        */
+        bool iterate(const size_t& iter);
     };
 
-    template<std::floating_point T, typename F, typename C>
-    std::vector<T> Solver<DE, T, F, C>::construct_donor()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<DE, T, F, C, N>::construct_donor(std::span<T, N> donor)
     {
-        std::vector<T> donor(de.ndv);
-        std::vector<size_t> r_i;
+        std::array<size_t, 3> r_i;
+        size_t nr_i = 0;
         //! Check that the indices are not the same
-        while (r_i.size() < 3)
+        while (nr_i < 3)
         {
-            r_i.push_back(indices[ind_distribution(generator)]);
-            if (r_i.size() > 1 && r_i.end()[-1] == r_i.end()[-2])
+            r_i[nr_i] = indices[ind_distribution(this->generator)];
+            if (nr_i == 0 || r_i[nr_i] != r_i[nr_i - 1])
             {
-                r_i.pop_back();
+                ++nr_i;
             }
         }
-        for (size_t j = 0; j < de.ndv; ++j)
+        const auto x0 = this->individuals[r_i[0]];
+        const auto x1 = this->individuals[r_i[1]];
+        const auto x2 = this->individuals[r_i[2]];
+        for (size_t j = 0; j < this->dim(); ++j)
         {
-            donor[j] = this->individuals[r_i[0]][j] + de.f_param * (this->individuals[r_i[1]][j] - this->individuals[r_i[2]][j]);
+            donor[j] = x0[j] + de.f_param * (x1[j] - x2[j]);
         }
-        return donor;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    std::vector<T> Solver<DE, T, F, C>::construct_trial(const std::vector<T>& target, const std::vector<T>& donor)
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<DE, T, F, C, N>::construct_trial(std::span<const T, N> target, std::span<const T, N> donor, std::span<T, N> trial)
     {
-        std::vector<T> trial(de.ndv);
-        std::vector<size_t> j_indices(de.ndv);
-        for (size_t j = 0; j < de.ndv; ++j)
+        std::uniform_int_distribution<size_t> j_ind_distribution(0, this->dim() - 1);
+        for (size_t j = 0; j < this->dim(); ++j)
         {
-            j_indices[j] = j;
-        }
-        std::uniform_int_distribution<size_t> j_ind_distribution(0, de.ndv - 1);
-        for (size_t j = 0; j < de.ndv; ++j)
-        {
-            const T& epsilon = this->distribution(generator);
-            const size_t& jrand = j_indices[j_ind_distribution(generator)];
+            const T& epsilon = this->distribution(this->generator);
+            const size_t& jrand = j_ind_distribution(this->generator);
             if (epsilon <= de.cr || j == jrand)
             {
                 trial[j] = donor[j];
@@ -169,39 +206,75 @@ namespace ea
                 trial[j] = target[j];
             }
         }
-        return trial;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<DE, T, F, C>::run_algo()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<DE, T, F, C, N>::asynchronous_generation()
     {
-        std::vector< std::vector<T> > personal_best = this->individuals;
-        //! Differential Evolution starts here
-        for (size_t iter = 0; iter < de.iter_max; ++iter)
+        for (size_t i = 0; i < this->individuals.size(); ++i)
         {
-            for (auto& p : this->individuals)
+            //! Construct donor and trial vectors
+            construct_donor(donor);
+            while (!this->check_constraints(donor))
             {
-                //! Construct donor and trial vectors
-                std::vector<T> donor = construct_donor();
-                while (!this->c(donor))
-                {
-                    donor = construct_donor();
-                }
-                const std::vector<T>& trial = construct_trial(p, donor);
-                if (this->f(trial) <= this->f(p))
-                {
-                    p = trial;
-                }
+                ++this->counters.resamples;
+                construct_donor(donor);
             }
-            //! Recalculate minimum cost individual of the population
-            this->find_min_cost();
-            //! Stopping Criteria
-            this->last_iter = iter;
-            if (de.tol > std::abs(this->f(this->min_cost)))
+            construct_trial(this->individuals[i], donor, trial);
+            //! The target's fitness is cached, only the trial vector is evaluated
+            const T trial_fitness = this->evaluate(trial);
+            if (trial_fitness <= this->individuals.fitness(i))
             {
-                this->solved_flag = true;
-                break;
+                this->individuals.set(i, trial, trial_fitness);
             }
         }
     }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<DE, T, F, C, N>::synchronous_generation()
+    {
+        for (size_t i = 0; i < this->individuals.size(); ++i)
+        {
+            construct_donor(donor);
+            while (!this->check_constraints(donor))
+            {
+                ++this->counters.resamples;
+                construct_donor(donor);
+            }
+            construct_trial(this->individuals[i], donor, trials[i]);
+        }
+        this->evaluate_population(trials);
+        Phase_timer phase{ this->counters.selection_time };
+        for (size_t i = 0; i < this->individuals.size(); ++i)
+        {
+            if (trials.fitness(i) <= this->individuals.fitness(i))
+            {
+                this->individuals.set(i, trials[i], trials.fitness(i));
+            }
+        }
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<DE, T, F, C, N>::iterate(const size_t& iter)
+    {
+        //! The trial vectors of a generation can only be evaluated together if none of them is compared with its target before the others are constructed
+        if (de.nthreads > 1 || batch_objective<F, T>)
+        {
+            synchronous_generation();
+        }
+        else
+        {
+            asynchronous_generation();
+        }
+        //! Recalculate minimum cost individual of the population
+        this->find_min_cost();
+        //! Stopping Criteria
+        this->last_iter = iter;
+        this->record_iteration(iter);
+        if (de.tol > std::abs(this->min_fitness))
+        {
+            this->solved_flag = true;
+        }
+        return this->solved_flag;
+    }
 }
\ No newline at end of file
@@ -12,12 +12,22 @@
 #include <utility>
 #include <chrono>
 #include <ctime>
-#include <boost/random/mersenne_twister.hpp>
+#include <cstdint>
 #include <random>
-#include <vector>
 #include <fstream>
 #include <sstream>
+#include <span>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <stop_token>
 #include "../utilities.h"
+#include "population.h"
+#include "thread_pool.h"
+#include "results_sink.h"
+#include "trace.h"
+#include "counters.h"
+#include "stopping.h"
 
 //! Evolutionary Algorithms
 namespace ea
@@ -32,6 +42,20 @@ namespace ea
             { s.run_algo() };
     };
 
+    /** \concept batch_objective
+    *  \brief An objective function that evaluates a batch of candidate solutions in one call
+    *  \details The candidates are stored row-major in the first argument, one after the other, and one cost per candidate is written to the second argument.
+    *  The solvers prefer this signature when it is available, so that the model can amortise its loops over the data across the whole batch.
+    */
+    template<typename F, typename T>
+    concept batch_objective =
+        requires(const F& f, std::span<const T> candidates, std::span<T> costs) {
+            { f(candidates, costs) };
+    };
+
+    /** \brief Default seed of the random number engines of the solvers */
+    constexpr std::uint64_t default_seed = 5489;
+
     template<std::floating_point T>
     struct EA_base
     {
@@ -58,9 +82,23 @@ namespace ea
         const bool print_to_output;
         /** \brief Print to file or not */
         const bool print_to_file;
+        /** \brief Seed of the random number engine of the solver */
+        const std::uint64_t seed;
+        /** \brief Number of threads used to evaluate the population, 1 evaluates serially. The objective function must be safe to call concurrently when it is greater than 1 */
+        const size_t nthreads;
+        /** \brief Number of iterations kept by the convergence trace of the solver, 0 disables the trace */
+        const size_t trace_capacity;
+        /** \brief Wall-clock time in seconds a solve may take from the construction of its solver, 0 for no limit */
+        const double time_budget;
+        /** \brief Stop token checked by the solvers before every iteration, the default token never requests a stop */
+        const std::stop_token cancellation;
+        /** \brief Additional stopping criteria checked at the end of every iteration, all disabled by default */
+        const Stopping_criteria<T> stopping;
     protected:
         /** \fn EA_base(const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev, const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
-            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type, const bool& i_print_to_output, const bool& i_print_to_file)
+            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type, const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed,
+            const size_t& i_nthreads, const size_t& i_trace_capacity, const double& i_time_budget, std::stop_token i_cancellation,
+            const Stopping_criteria<T>& i_stopping)
         *	\brief Constructor
         *	\param i_decision_variables The starting values of the decision variables
         *	\param i_stdev The standard deviation
@@ -71,12 +109,22 @@ namespace ea
         *	\param i_constraints_type What kind of constraints to use
         *	\param i_print_to_output Whether to print to terminal or not
         *	\param i_print_to_file Whether to print to a file or not
+        *	\param i_seed The seed of the random number engine of the solver
+        *	\param i_nthreads The number of threads used to evaluate the population
+        *	\param i_trace_capacity The number of iterations kept by the convergence trace, 0 disables it
+        *	\param i_time_budget The wall-clock time in seconds a solve may take from the construction of its solver, 0 for no limit
+        *	\param i_cancellation A stop token, a solve stops at the first iteration after a stop is requested on it
+        *	\param i_stopping Additional stopping criteria
         *	\return A EA_base<T> object
             */
         EA_base(const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev, const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
-            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type, const bool& i_print_to_output, const bool& i_print_to_file)
+            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type, const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed,
+            const size_t& i_nthreads, const size_t& i_trace_capacity, const double& i_time_budget, std::stop_token i_cancellation,
+            const Stopping_criteria<T>& i_stopping)
             : decision_variables{ i_decision_variables }, stdev{ i_stdev }, npop{ i_npop }, tol{ i_tol }, iter_max{ i_iter_max }, ndv{ i_decision_variables.size() },
-            use_penalty_method{ i_use_penalty_method }, constraints_type{ i_constraints_type }, print_to_output{ i_print_to_output }, print_to_file{ i_print_to_file }
+            use_penalty_method{ i_use_penalty_method }, constraints_type{ i_constraints_type }, print_to_output{ i_print_to_output }, print_to_file{ i_print_to_file },
+            seed{ i_seed }, nthreads{ i_nthreads }, trace_capacity{ i_trace_capacity }, time_budget{ i_time_budget },
+            cancellation{ std::move(i_cancellation) }, stopping{ i_stopping }
         {
             assert(decision_variables.size() > 0);
             assert(decision_variables.size() == stdev.size());
@@ -87,16 +135,73 @@ namespace ea
             assert(npop > 0);
             assert(tol > 0);
             assert(iter_max > 0);
+            assert(nthreads > 0);
+            assert(time_budget >= 0);
         }
     };
-    /** \fn generator
-    *  \brief Pseudo-random number generator
-    *  \return A random number
+    /** \brief Pseudo-random number engine, every solver owns one so that solves are reproducible and independent of each other */
+    using Random_engine = std::mt19937_64;
+    /** \fn derive_seed(const std::uint64_t& seed, const std::uint64_t& stream)
+    *  \brief Derives the seed of a child solver (for example the i-th nested solve) from the seed of its parent
+    *  \details Uses the splitmix64 finaliser, so that nearby streams produce uncorrelated seeds at the cost of a few integer operations
+    *  \param seed The seed of the parent solver
+    *  \param stream The index of the child solver
+    *  \return The seed of the child solver
     */
-    boost::mt19937 generator;
+    constexpr std::uint64_t derive_seed(const std::uint64_t& seed, const std::uint64_t& stream)
+    {
+        std::uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+    /** \struct Result
+    *  \brief The outcome of a solve
+    */
+    template<std::floating_point T>
+    struct Result
+    {
+        /** \brief Best solution */
+        std::vector<T> min_cost;
+        /** \brief Fitness of the best solution */
+        T min_fitness;
+        /** \brief Whether the tolerance was reached within the maximum number of iterations */
+        bool solved;
+        /** \brief Why the solve stopped, the solution is the best found so far when it stopped early */
+        Stop_reason reason;
+        /** \brief Last iteration */
+        size_t last_iter;
+        /** \brief Duration of the solve in seconds, without the initialisation of the population */
+        double elapsed_time;
+        /** \brief Counters of the operations and times of the phases */
+        Counters counters;
+    };
     /*! \class Solver
-    *  \brief Template Class for Solvers */
-    template<template<typename> class S, std::floating_point T, typename F, typename C> class Solver;
+    *  \brief Template Class for Solvers
+    *  \details N is the number of decision variables when it is known at compile time (for example 6 for the Nelson-Siegel-Svensson model
+    *  and 1 for the internal rate of return), in which case the individuals are fixed-size and the loops over the decision variables are unrolled.
+    *  It is std::dynamic_extent when the number of decision variables is only known at runtime.
+    */
+    template<template<typename> class S, std::floating_point T, typename F, typename C, size_t N = std::dynamic_extent> class Solver;
+
+    /** \fn has_random_initial_population()
+    *  \brief Whether a solver starts from a random initial population, which the base class samples and evaluates
+    *  \details The parameter structures of the solvers that iterate from their starting values, like the root finder, set random_initial_population to false.
+    *  Their population holds the starting values until the solver replaces them, and it is not evaluated.
+    *  \return False if S<T>::random_initial_population is false, true otherwise
+    */
+    template<template<typename> class S, std::floating_point T>
+    constexpr bool has_random_initial_population()
+    {
+        if constexpr (requires { S<T>::random_initial_population; })
+        {
+            return S<T>::random_initial_population;
+        }
+        else
+        {
+            return true;
+        }
+    }
     
     /*! \class Solver_base
     *  \brief Base Class for Evolutionary Algorithms
@@ -105,37 +210,140 @@ namespace ea
     *  At the same time, std::function could be have been used, thus eliminating the need for template parameters F and C.
     *  However, that comes at a runtime cost, since calls to the functions would be virtual and there is a possibility
     *  that allocation could happen on the heap.*/
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
     class Solver_base
     {
     public:
-        /*! \fn solver_bench(const std::string& problem_name)
+        /*! \fn solver_bench(std::string_view problem_name, std::ostream& output)
         *  \brief Solve wrapper function for Solvers, used for benchmarks
         *  \param problem_name The name of the problem in std::string form
-        *  \return The solution vector
+        *  \param output The stream the results are printed to when print_to_output is set
+        *  \return The solution vector, its fitness and the counters of the solve
+        */
+        Result<T> solver_bench(std::string_view problem_name, std::ostream& output = std::cout);
+        /*! \fn convergence_trace() const
+        *  \brief The convergence trace of the last solve, empty when the trace_capacity of the parameter structure is 0
+        *  \return A reference to the trace
+        */
+        const Trace<T>& convergence_trace() const { return trace; }
+        /*! \fn solved() const
+        *  \return Whether the last solve reached the tolerance within the maximum number of iterations
+        */
+        bool solved() const { return solved_flag; }
+        /*! \fn stop_reason() const
+        *  \return Why the last solve stopped
+        */
+        Stop_reason stop_reason() const { return reason; }
+        /*! \fn best_fitness() const
+        *  \return The fitness of the best solution
+        */
+        const T& best_fitness() const { return min_fitness; }
+        /*! \fn evaluation_count() const
+        *  \return The number of objective function evaluations, including those of the initial population
+        */
+        size_t evaluation_count() const { return counters.evaluations; }
+        /*! \fn solve_counters() const
+        *  \return The counters of the operations and the times of the phases of the last solve
+        */
+        const Counters& solve_counters() const { return counters; }
+        /*! \fn iteration_count() const
+        *  \return The last iteration of the last solve
+        */
+        size_t iteration_count() const { return last_iter; }
+        /*! \fn elapsed_time() const
+        *  \return The duration of the last solve in seconds
+        */
+        T elapsed_time() const { return timer; }
+        /*! \fn result() const
+        *  \return The solution vector, its fitness and the counters of the last solve
+        */
+        Result<T> result() const { return { min_cost, min_fitness, solved_flag, reason, last_iter, static_cast<double>(timer), counters }; }
+        /*! \fn run_iterations(const size_t& first, const size_t& last)
+        *  \brief Runs the iterations first to last - 1 of the algorithm, so that a solve can be run in epochs, for example by the island model
+        *  \param first The first iteration
+        *  \param last The iteration after the last one
+        *  \return True if the stopping criteria are met
+        */
+        bool run_iterations(const size_t& first, const size_t& last);
+        /*! \fn start_solve()
+        *  \brief Clears the convergence trace and the elapsed time before the iterations of a solve, as solver_bench does
+        *  \details The counters of the first solve include the initialisation of the population, those of a later solve start from zero
+        *  \return void
+        */
+        void start_solve();
+        /*! \fn run_timed_iterations(const size_t& first, const size_t& last)
+        *  \brief Runs the iterations first to last - 1 as run_iterations does and times them as solver_bench times a solve
+        *  \details The duration is added to the elapsed time, and the part of it that is not spent evaluating or selecting to the other time
+        *  \param first The first iteration
+        *  \param last The iteration after the last one
+        *  \return True if the stopping criteria are met
+        */
+        bool run_timed_iterations(const size_t& first, const size_t& last);
+        /*! \fn set_cancellation(std::stop_token token)
+        *  \brief Makes the solve stop, with the best solution so far, at the first iteration after a stop is requested on the token
+        *  \details Replaces the token of the parameter structure
+        *  \param token The stop token, for example of the other solvers of a portfolio
+        *  \return void
+        */
+        void set_cancellation(std::stop_token token) { cancellation = std::move(token); }
+        /*! \fn emigrants(const size_t& n, Population<T, N>& migrants) const
+        *  \brief Copies the best individuals of the population, used for migration between islands
+        *  \param n The number of individuals, at most the size of the population
+        *  \param migrants The best individuals and their fitness in ascending order of fitness, overwritten by this method
+        *  \return void
+        */
+        void emigrants(const size_t& n, Population<T, N>& migrants) const;
+        /*! \fn immigrate(const Population<T, N>& migrants)
+        *  \brief Replaces the worst individuals of the population with the migrants that are better than them
+        *  \details The best migrant is matched with the worst individual, the second best with the second worst and so on.
+        *  Solvers that keep more state per individual than its position, like the bests of the particle swarms, update it in accept_immigrant.
+        *  \param migrants The migrants in ascending order of fitness, as written by emigrants()
+        *  \return void
         */
-        std::vector<T> solver_bench(std::string_view problem_name);
+        void immigrate(const Population<T, N>& migrants);
     protected:
-        /*! \fn Solver_base(const S<T>& i_solver_struct, const F& i_f, const C& i_c)
+        /*! \fn Solver_base(const S<T>& i_solver_struct, const F& i_f, const C& i_c, const std::uint64_t& i_seed)
         *  \brief Constructor
         *  \param i_solver_struct The parameter structure that is used to construct the solver
         *  \param i_f A reference to the objective function
         *  \param i_c A reference to the constraints function
-        *  \return A Solver_base<Derived, S, T, F, C> object
+        *  \param i_seed The seed of the random number engine
+        *  \return A Solver_base<Derived, S, T, F, C, N> object
         */
-        Solver_base(const S<T>& i_solver_struct, const F& i_f, const C& i_c) :
+        Solver_base(const S<T>& i_solver_struct, const F& i_f, const C& i_c, const std::uint64_t& i_seed) :
             solver_struct{ i_solver_struct },
             f{ i_f },
             c{ i_c },
+            generator{ i_seed },
+            pool{ i_solver_struct.nthreads },
+            counters{},
+            deadline{ std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(i_solver_struct.time_budget)) },
             individuals{ init_individuals() },
-            min_cost{ individuals[0] },
+            min_cost{ individuals[0].begin(), individuals[0].end() },
+            min_fitness{ 0 },
             last_iter{ 0 },
             solved_flag{ false },
+            reason{ Stop_reason::max_iterations },
             timer{ 0 },
-            distribution{ std::uniform_real_distribution<T>(0.0, 1.0) }
+            started{ false },
+            distribution{ std::uniform_real_distribution<T>(0.0, 1.0) },
+            batch{},
+            batch_costs{},
+            trace{ i_solver_struct.trace_capacity, i_solver_struct.ndv },
+            cancellation{ i_solver_struct.cancellation },
+            monitor{ i_solver_struct.stopping }
         {
-            generator.discard(700000);
-            find_min_cost();
+            assert(N == std::dynamic_extent || solver_struct.ndv == N);
+            if constexpr (has_random_initial_population<S, T>())
+            {
+                evaluate_population(individuals);
+                min_fitness = individuals.fitness(0);
+                find_min_cost();
+            }
+            else
+            {
+                min_fitness = std::numeric_limits<T>::infinity();
+            }
         }
         /** \brief Internal reference to the structure used for parameters of the algorithm */
         const S<T>& solver_struct;
@@ -143,90 +351,405 @@ namespace ea
         F f;
         /** \brief Copy of the constraints function passed as a lambda */
         C c;
-        /** \brief Population */
-        std::vector<std::vector<T>> individuals;
+        /** \brief Random number engine of the solver */
+        Random_engine generator;
+        /** \brief Threads used to evaluate the population */
+        Thread_pool pool;
+        /** \brief Counters of the operations and times of the phases, declared before the population since they count its initialisation */
+        Counters counters;
+        /** \brief End of the time budget, declared before the population since the budget includes its initialisation */
+        std::chrono::time_point<std::chrono::steady_clock> deadline;
+        /** \brief Population, the fitness of each individual is updated only when the individual changes */
+        Population<T, N> individuals;
         /** \brief Best solution / lowest fitness */
         std::vector<T> min_cost;
+        /** \brief Fitness of the best solution */
+        T min_fitness;
         /** \brief  Last iteration to solution */
         size_t last_iter;
         /** \brief A flag which determines if the solver has already solved the problem */
         bool solved_flag;
+        /** \brief Why the solve stopped */
+        Stop_reason reason;
         /** \brief The timer used for benchmarks */
         T timer;
+        /** \brief Whether a solve has already started, the counters of the first solve include the initialisation of the population */
+        bool started;
         /** \brief Uniform real distribution */
         std::uniform_real_distribution<T> distribution;
-        /*! \fn randomise_individual()
-        *  \brief Returns a randomised individual using the initial decision variables and standard deviation
-        *  \return A randomised individual of type std::vector<T>, where T is a floating-point number type.
+        /** \brief Candidates gathered for a batch objective function, reused across generations */
+        std::vector<T> batch;
+        /** \brief Costs written by a batch objective function, reused across generations */
+        std::vector<T> batch_costs;
+        /** \brief Convergence trace, recorded at the end of every iteration */
+        Trace<T> trace;
+        /** \brief Stop token checked before every iteration */
+        std::stop_token cancellation;
+        /** \brief Evaluates the additional stopping criteria at the end of every iteration */
+        Stopping_monitor<T> monitor;
+        /*! \fn interrupted()
+        *  \brief Checks the cancellation token and the time budget, called once per iteration
+        *  \return True if the solve has to stop, in which case the reason is set
+        */
+        bool interrupted()
+        {
+            if (cancellation.stop_requested())
+            {
+                reason = Stop_reason::cancelled;
+                return true;
+            }
+            if (solver_struct.time_budget > 0 && std::chrono::steady_clock::now() >= deadline)
+            {
+                reason = Stop_reason::deadline;
+                return true;
+            }
+            return false;
+        }
+        /*! \fn dim() const
+        *  \brief Number of decision variables, a compile-time constant when N is known at compile time
+        *  \return The number of decision variables
+        */
+        constexpr size_t dim() const
+        {
+            if constexpr (N == std::dynamic_extent)
+            {
+                return solver_struct.ndv;
+            }
+            else
+            {
+                return N;
+            }
+        }
+        /*! \fn randomise_individual(std::span<T, N> individual)
+        *  \brief Randomises an individual using the initial decision variables and standard deviation
+        *  \param individual The individual to be overwritten
+        *  \return void
+        */
+        void randomise_individual(std::span<T, N> individual);
+        /*! \fn evaluate(std::span<const T> individual)
+        *  \brief Evaluates the objective function, counts the evaluation and adds its time to the evaluation time
+        *  \param individual The candidate solution to be evaluated
+        *  \return The fitness of the candidate solution
+        */
+        T evaluate(std::span<const T> individual);
+        /*! \fn evaluate_population(Population<T, N>& population, std::span<const size_t> indices)
+        *  \brief Evaluates some individuals of a population, in parallel when the solver uses more than one thread
+        *  \param population The population, the fitness of the evaluated individuals is overwritten
+        *  \param indices The indices of the individuals to be evaluated
+        *  \return void
+        */
+        void evaluate_population(Population<T, N>& population, std::span<const size_t> indices);
+        /*! \fn evaluate_population(Population<T, N>& population)
+        *  \brief Evaluates all the individuals of a population, in parallel when the solver uses more than one thread
+        *  \param population The population, the fitness of every individual is overwritten
+        *  \return void
+        */
+        void evaluate_population(Population<T, N>& population);
+        /*! \fn evaluate_batch(std::span<const T> candidates, std::span<T> costs)
+        *  \brief Evaluates contiguous candidates with a batch objective function, split in one batch per thread
+        *  \param candidates The candidate solutions, stored row-major
+        *  \param costs The fitness of the candidates, overwritten by this method
+        *  \return void
+        */
+        void evaluate_batch(std::span<const T> candidates, std::span<T> costs);
+        /*! \fn check_constraints(std::span<const T> individual)
+        *  \brief Evaluates the constraints function
+        *  \param individual The candidate solution to be checked
+        *  \return True if the constraints are satisfied, false otherwise
         */
-        std::vector<T> randomise_individual();
+        bool check_constraints(std::span<const T> individual);
         /*! \fn init_individuals()
         *  \brief Initialises the population by randomising aroung the decision variables using the given standard deviation
         *  \return The population after checking the constraints of the optimisation problem
         */
-        std::vector<std::vector<T>> init_individuals();
+        Population<T, N> init_individuals();
         /*! \fn find_min_cost()
         *  \brief Find the minimum cost individual of the fitness function for the population
         *  \return void
         */
         void find_min_cost();
+        /*! \fn record_iteration(const size_t& iteration)
+        *  \brief Records the state of the population in the convergence trace, does nothing when the trace is disabled
+        *  \param iteration The iteration that has just finished
+        *  \return void
+        */
+        void record_iteration(const size_t& iteration)
+        {
+            if (trace.enabled())
+            {
+                trace.record(iteration, counters.evaluations, min_fitness, individuals);
+            }
+        }
+        /*! \fn timed(const Fn& run)
+        *  \brief Runs iterations of the solver, adds their duration to the elapsed time and the part of it that is not spent evaluating or selecting
+        *  to the other time
+        *  \param run The function that runs the iterations
+        *  \return void
+        */
+        template<typename Fn>
+        void timed(const Fn& run);
         /*! \fn display_results()
         *  \brief Display the results of execution of an algorithm as well as its parameters
         *  \return A std::stringstream of the results
         */
         std::stringstream display_results();
-        /*! \fn write_results_to_file(const std::string& problem_name)
-        *  \brief Write the results to a file
+        /*! \fn write_results_to_file(std::string_view problem_name, std::string results)
+        *  \brief Write the results to a file, the file is appended to by the Results_sink on its background thread
         *  \param problem_name The name of the problem in std::string form
+        *  \param results The results formatted by display_results()
         *  \return void
         */
-        void write_results_to_file(std::string_view problem_name);
+        void write_results_to_file(std::string_view problem_name, std::string results);
     };
 
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
-    std::vector<T> Solver_base<Derived, S, T, F, C>::randomise_individual()
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::randomise_individual(std::span<T, N> individual)
     {
-        std::vector<T> individual = solver_struct.decision_variables;
         T epsilon = 0;
-        for (size_t j = 0; j < solver_struct.ndv; ++j)
+        for (size_t j = 0; j < dim(); ++j)
         {
             std::normal_distribution<T> ndistribution(0, solver_struct.stdev[j]);
             epsilon = ndistribution(generator);
-            individual[j] = individual[j] + epsilon;
+            individual[j] = solver_struct.decision_variables[j] + epsilon;
         }
-        return individual;
     }
 
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
-    std::vector<std::vector<T>> Solver_base<Derived, S, T, F, C>::init_individuals()
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    T Solver_base<Derived, S, T, F, C, N>::evaluate(std::span<const T> individual)
     {
-        std::vector<std::vector<T>> individuals(solver_struct.npop, std::vector<T>(solver_struct.ndv));
-        for (auto& p : individuals)
+        ++counters.evaluations;
+        //! The asynchronous DE generation and the root finder evaluate one candidate at a time, so every evaluation is timed
+        Phase_timer phase{ counters.evaluation_time };
+        //! A single candidate is evaluated with the scalar signature whenever the objective function has one, a batch of one wastes the batch kernels
+        if constexpr (std::invocable<const F&, std::span<const T>>)
+        {
+            return f(individual);
+        }
+        else
         {
-            p = randomise_individual();
+            T cost = 0;
+            f(individual, std::span<T>(&cost, 1));
+            return cost;
+        }
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::evaluate_population(Population<T, N>& population, std::span<const size_t> indices)
+    {
+        if constexpr (batch_objective<F, T>)
+        {
+            //! The individuals are gathered so that the objective function sees one contiguous batch
+            batch.resize(indices.size() * dim());
+            batch_costs.resize(indices.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                const auto individual = std::as_const(population)[indices[i]];
+                std::copy(individual.begin(), individual.end(), batch.begin() + i * dim());
+            }
+            evaluate_batch(batch, batch_costs);
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                population.fitness(indices[i]) = batch_costs[i];
+            }
+        }
+        else
+        {
+            //! Only the objective function runs on the workers, the evaluations are counted here
+            Phase_timer phase{ counters.evaluation_time };
+            pool.parallel_for(indices.size(), [&](const size_t& i)
+                {
+                    population.fitness(indices[i]) = f(std::span<const T>(std::as_const(population)[indices[i]]));
+                });
+            counters.evaluations += indices.size();
+        }
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::evaluate_population(Population<T, N>& population)
+    {
+        if constexpr (batch_objective<F, T>)
+        {
+            evaluate_batch(std::as_const(population).data(), population.fitness());
+        }
+        else
+        {
+            Phase_timer phase{ counters.evaluation_time };
+            pool.parallel_for(population.size(), [&](const size_t& i)
+                {
+                    population.fitness(i) = f(std::span<const T>(std::as_const(population)[i]));
+                });
+            counters.evaluations += population.size();
+        }
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::evaluate_batch(std::span<const T> candidates, std::span<T> costs)
+    {
+        if constexpr (batch_objective<F, T>)
+        {
+            assert(candidates.size() == costs.size() * dim());
+            Phase_timer phase{ counters.evaluation_time };
+            const size_t nbatches = std::min(pool.size(), costs.size());
+            pool.parallel_for(nbatches, [&](const size_t& k)
+                {
+                    const size_t begin = k * costs.size() / nbatches;
+                    const size_t end = (k + 1) * costs.size() / nbatches;
+                    f(candidates.subspan(begin * dim(), (end - begin) * dim()), costs.subspan(begin, end - begin));
+                });
+            counters.evaluations += costs.size();
+        }
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    bool Solver_base<Derived, S, T, F, C, N>::check_constraints(std::span<const T> individual)
+    {
+        ++counters.constraint_evaluations;
+        const bool satisfied = c(individual);
+        counters.constraint_rejections += satisfied ? 0 : 1;
+        return satisfied;
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    Population<T, N> Solver_base<Derived, S, T, F, C, N>::init_individuals()
+    {
+        Phase_timer phase{ counters.init_time };
+        Population<T, N> individuals(solver_struct.npop, solver_struct.ndv);
+        if constexpr (!has_random_initial_population<S, T>())
+        {
+            for (size_t i = 0; i < individuals.size(); ++i)
+            {
+                std::copy(solver_struct.decision_variables.begin(), solver_struct.decision_variables.end(), individuals[i].begin());
+            }
+            return individuals;
+        }
+        for (size_t i = 0; i < individuals.size(); ++i)
+        {
+            randomise_individual(individuals[i]);
             //! Check population constraints
-            while (!c(p))
+            while (!check_constraints(individuals[i]))
             {
-                p = randomise_individual();
+                ++counters.resamples;
+                randomise_individual(individuals[i]);
             }
         }
         return individuals;
     }
     
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
-    void Solver_base<Derived, S, T, F, C>::find_min_cost()
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::find_min_cost()
     {
-        for (const auto& p : individuals)
+        Phase_timer phase{ counters.selection_time };
+        for (size_t i = 0; i < individuals.size(); ++i)
         {
-            if (f(min_cost) > f(p))
+            if (min_fitness > individuals.fitness(i))
             {
-                min_cost = p;
+                min_cost.assign(individuals[i].begin(), individuals[i].end());
+                min_fitness = individuals.fitness(i);
             }
         }
     }
 
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
-    std::stringstream Solver_base<Derived, S, T, F, C>::display_results()
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    bool Solver_base<Derived, S, T, F, C, N>::run_iterations(const size_t& first, const size_t& last)
+    {
+        for (size_t iter = first; iter < last; ++iter)
+        {
+            if (interrupted())
+            {
+                return false;
+            }
+            if (static_cast<Derived*>(this)->iterate(iter))
+            {
+                reason = Stop_reason::tolerance;
+                return true;
+            }
+            if (monitor.met(counters.evaluations, min_fitness, std::span<const T>(min_cost), std::as_const(individuals)))
+            {
+                reason = monitor.reason();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::start_solve()
+    {
+        timer = 0;
+        if (started)
+        {
+            counters = Counters{};
+        }
+        started = true;
+        trace.restart();
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    bool Solver_base<Derived, S, T, F, C, N>::run_timed_iterations(const size_t& first, const size_t& last)
+    {
+        bool met = false;
+        timed([&]() { met = run_iterations(first, last); });
+        return met;
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    template<typename Fn>
+    void Solver_base<Derived, S, T, F, C, N>::timed(const Fn& run)
+    {
+        //! The time that is not spent evaluating or selecting is other
+        const double evaluation_time = counters.evaluation_time;
+        const double selection_time = counters.selection_time;
+        const std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start;
+        timer += static_cast<T>(elapsed_seconds.count());
+        counters.other_time += std::max(elapsed_seconds.count() - (counters.evaluation_time - evaluation_time) - (counters.selection_time - selection_time), 0.0);
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::emigrants(const size_t& n, Population<T, N>& migrants) const
+    {
+        std::vector<size_t> order(individuals.size());
+        std::iota(order.begin(), order.end(), 0);
+        const auto middle = order.begin() + std::min(n, order.size());
+        std::partial_sort(order.begin(), middle, order.end(), [&](const size_t& l, const size_t& r) { return individuals.fitness(l) < individuals.fitness(r); });
+        migrants.clear();
+        for (auto it = order.begin(); it != middle; ++it)
+        {
+            migrants.push_back(individuals[*it], individuals.fitness(*it));
+        }
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::immigrate(const Population<T, N>& migrants)
+    {
+        Phase_timer phase{ counters.selection_time };
+        std::vector<size_t> order(individuals.size());
+        std::iota(order.begin(), order.end(), 0);
+        const size_t n = std::min(migrants.size(), order.size());
+        std::partial_sort(order.begin(), order.begin() + n, order.end(), [&](const size_t& l, const size_t& r) { return individuals.fitness(l) > individuals.fitness(r); });
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t i = order[k];
+            if (!(migrants.fitness(k) < individuals.fitness(i)))
+            {
+                continue;
+            }
+            individuals.set(i, migrants[k], migrants.fitness(k));
+            if constexpr (requires(Derived& d) { d.accept_immigrant(i); })
+            {
+                static_cast<Derived*>(this)->accept_immigrant(i);
+            }
+            if (migrants.fitness(k) < min_fitness)
+            {
+                min_cost.assign(migrants[k].begin(), migrants[k].end());
+                min_fitness = migrants.fitness(k);
+            }
+        }
+    }
+
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    std::stringstream Solver_base<Derived, S, T, F, C, N>::display_results()
     {
         std::stringstream results;
         results << "Algorithm:" << "," << solver_struct.type << "," << "Solved:" << ",";
@@ -238,16 +761,31 @@ namespace ea
         {
             results << "True" << ",";
         }
+        results << "Stop Reason:" << "," << stop_reason_name(reason) << ",";
         results << "Solution:" << "," <<  min_cost << ",";
-        results << "Fitness:" << "," << f(min_cost) << ",";
+        results << "Fitness:" << "," << min_fitness << ",";
         results << "Population:" << "," << individuals.size() << ",";
         results << "Iterations:" << "," << last_iter << ",";
+        results << "Evaluations:" << "," << counters.evaluations << ",";
         results << "Elapsed Time:" << "," << timer << ",";
+        results << "Constraint Evaluations:" << "," << counters.constraint_evaluations << ",";
+        results << "Constraint Rejections:" << "," << counters.constraint_rejections << ",";
+        results << "Resamples:" << "," << counters.resamples << ",";
+        results << "Initialisation Time:" << "," << counters.init_time << ",";
+        results << "Evaluation Time:" << "," << counters.evaluation_time << ",";
+        results << "Other Time:" << "," << counters.other_time << ",";
+        results << "Selection Time:" << "," << counters.selection_time << ",";
         results << "Starting Values:" << "," << solver_struct.decision_variables << ",";
         results << "Standard Deviation:" << "," << solver_struct.stdev << ",";
         results << "Initial Population:" << "," << solver_struct.npop << ",";
         results << "Tolerance:" << "," << solver_struct.tol << ",";
         results << "Maximum Iterations:" << "," << solver_struct.iter_max << ",";
+        results << "Threads:" << "," << solver_struct.nthreads << ",";
+        results << "Time Budget:" << "," << solver_struct.time_budget << ",";
+        results << "Stagnation Iterations:" << "," << solver_struct.stopping.stagnation << ",";
+        results << "Radius:" << "," << solver_struct.stopping.radius << ",";
+        results << "Maximum Evaluations:" << "," << solver_struct.stopping.max_evaluations << ",";
+        results << "Relative Tolerance:" << "," << solver_struct.stopping.relative_tol << ",";
         results << "Using Penalty Function:" << "," << solver_struct.use_penalty_method << ",";
         results << "Using Constraints:" << ",";
         switch (solver_struct.constraints_type)
@@ -260,61 +798,89 @@ namespace ea
         return results;
     }
     
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
-    void Solver_base<Derived, S, T, F, C>::write_results_to_file(std::string_view problem_name)
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Solver_base<Derived, S, T, F, C, N>::write_results_to_file(std::string_view problem_name, std::string results)
     {
         std::string filename;
         filename.append(problem_name);
         //filename.append("-");
         //filename.append(solver_struct.type);
         filename.append("-results.csv");
-        std::ofstream out;
-        out.open(filename, std::ofstream::out | std::ofstream::app);
-        out << display_results().str();
+        Results_sink::instance().submit(std::move(filename), std::move(results));
     }
     
-    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C>
-    std::vector<T> Solver_base<Derived, S, T, F, C>::solver_bench(std::string_view problem_name)
+    template<typename Derived, template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    Result<T> Solver_base<Derived, S, T, F, C, N>::solver_bench(std::string_view problem_name, std::ostream& output)
     {
-        if (solver_struct.tol > std::abs(f(min_cost)))
+        if (has_random_initial_population<S, T>() && solver_struct.tol > std::abs(min_fitness))
         {
+            //! The initial population already reached the tolerance
             timer = 0;
+            solved_flag = true;
+            reason = Stop_reason::tolerance;
         }
         else
         {
             //! Time the computation
-            const std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
-            static_cast<Derived*>(this)->run_algo();
-            const std::chrono::time_point<std::chrono::system_clock> end = std::chrono::system_clock::now();
-            const std::chrono::duration<double> elapsed_seconds = end - start;
-            timer = elapsed_seconds.count();
+            start_solve();
+            timed([&]() { static_cast<Derived*>(this)->run_algo(); });
         }
         //! Return minimum cost individual
+        if (!solver_struct.print_to_output && !solver_struct.print_to_file)
+        {
+            return result();
+        }
+        //! The results are formatted once for the terminal and the file
+        std::string results = display_results().str();
         if (solver_struct.print_to_output)
         {
-            std::cout << display_results().str();
+            output << results;
         }
         else {};
         if (solver_struct.print_to_file)
         {
-            write_results_to_file(problem_name);
+            write_results_to_file(problem_name, std::move(results));
+            if (trace.enabled())
+            {
+                std::stringstream records;
+                trace.write_csv(records);
+                Results_sink::instance().submit(std::string(problem_name) + "-trace.csv", records.str());
+            }
         }
         else {};
-        return min_cost;
+        return result();
     }
     
-    /*! \fn solve(const F& f, const C& c, const S<T>& solver_struct, const std::string& problem_name)
+    /*! \fn solve(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name, const std::uint64_t& seed, std::ostream& output)
     *  \brief Solver wrapper function, interface to solvers : free function used for benchmarks
+    *  \details The number of decision variables N can be given explicitly, for example solve<6>(f, c, solver_struct, problem_name),
+    *  to use fixed-size individuals
+    *  \param f The objective function
+    *  \param c The constraints function
+    *  \param solver_struct The parameter structure of the solver
+    *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
+    *  \param seed The seed of the random number engine, solves with the same seed give identical results
+    *  \param output The stream the results are printed to when print_to_output is set, for example a buffer when solves run concurrently
+    *  \return The solution vector, its fitness and the counters of the solve
+    */
+    template<size_t N = std::dynamic_extent, typename F, typename C, template<typename> class S, std::floating_point T>
+    Result<T> solve(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name, const std::uint64_t& seed, std::ostream& output = std::cout)
+    {
+        Solver<S, T, F, C, N> solver{ solver_struct, f, c, seed };
+        return solver.solver_bench(problem_name, output);
+    }
+
+    /*! \fn solve(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name)
+    *  \brief Solver wrapper function using the seed of the parameter structure
     *  \param f The objective function
     *  \param c The constraints function
     *  \param solver_struct The parameter structure of the solver
     *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
-    *  \return The solution vector
+    *  \return The solution vector, its fitness and the counters of the solve
     */
-    template<typename F, typename C, template<typename> class S, std::floating_point T>
-    std::vector<T> solve(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name)
+    template<size_t N = std::dynamic_extent, typename F, typename C, template<typename> class S, std::floating_point T>
+    Result<T> solve(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name)
     {
-        Solver<S, T, F, C> solver{ solver_struct, f, c };
-        return solver.solver_bench(problem_name);
+        return solve<N>(f, c, solver_struct, problem_name, solver_struct.seed);
     }
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "ealgorithm_base.h"
+#include <numeric>
+#include <limits>
 #include <boost/math/distributions.hpp>
 
 namespace ea
@@ -14,6 +16,55 @@ namespace ea
     //! Replacing or remove individuals strategies during mutation
     enum class Strategy { keep_same, re_mutate, remove, none };
 
+    /*! \class Quantile_table
+    *  \brief Quantile function of a distribution with bounded support, tabulated at equally spaced probabilities and sampled by linear interpolation
+    *  \details The quantiles are computed once at construction. A sample then costs a multiplication and an interpolation between two knots,
+    *  instead of the root finding of the quantile of a distribution such as Beta. The samples have the exact probabilities of the distribution
+    *  at the knots, so their cumulative distribution function is within 1 / size of the exact one.
+    */
+    template<std::floating_point T>
+    class Quantile_table
+    {
+    public:
+        /** \fn Quantile_table(const D& distribution, const size_t& size)
+        *  \brief Constructor
+        *  \param distribution A boost::math distribution with bounded support
+        *  \param size The number of intervals of the table
+        *  \return A Quantile_table<T> object
+        */
+        template<typename D>
+        Quantile_table(const D& distribution, const size_t& size = 1024) :
+            quantiles(size + 1)
+        {
+            assert(size > 0);
+            for (size_t k = 0; k <= size; ++k)
+            {
+                quantiles[k] = boost::math::quantile(distribution, static_cast<T>(k) / static_cast<T>(size));
+            }
+        }
+        /** \fn operator()(const T& u) const
+        *  \param u A probability in [0, 1)
+        *  \return The interpolated quantile of u
+        */
+        T operator()(const T& u) const
+        {
+            const size_t size = quantiles.size() - 1;
+            const T x = u * static_cast<T>(size);
+            const size_t k = std::min(static_cast<size_t>(x), size - 1);
+            return quantiles[k] + (x - static_cast<T>(k)) * (quantiles[k + 1] - quantiles[k]);
+        }
+        /** \fn size() const
+        *  \return The number of intervals of the table
+        */
+        size_t size() const
+        {
+            return quantiles.size() - 1;
+        }
+    private:
+        /** \brief Quantiles at the knots k / size, k = 0, ..., size */
+        std::vector<T> quantiles;
+    };
+
     /** \struct GA
     *  \brief Genetic Algorithms Structure, used in the actual algorithm and for type deduction
     */
@@ -24,7 +75,10 @@ namespace ea
         /** \fn GA(const T& i_x_rate, const T& i_pi, const T& i_alpha, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max, const bool& i_use_penalty_method = false,
             const Constraints_type& i_constraints_type = Constraints_type::none, const Strategy& i_strategy = Strategy::keep_same,
-            const bool& i_print_to_output = true, const bool& i_print_to_file = true)
+            const bool& i_print_to_output = true, const bool& i_print_to_file = true, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {},
+            const size_t& i_max_npop = 1000)
         *	\brief Constructor
         *	\param i_x_rate Selection Rate or percentage of population to keep up to the next generation
         *	\param i_pi Probability of mutation
@@ -39,20 +93,32 @@ namespace ea
         *	\param i_constraints_type What kind of constraints to use
         *	\param i_print_to_output Whether to print to terminal or not
         *	\param i_print_to_file Whether to print to a file or not
+        *	\param i_seed The seed of the random number engine of the solver
+        *	\param i_nthreads The number of threads used to evaluate the offspring of each generation
+        *	\param i_trace_capacity The number of iterations kept by the convergence trace, 0 disables it
+        *	\param i_time_budget The wall-clock time in seconds the solve may take from the construction of the solver, 0 for no limit
+        *	\param i_cancellation A stop token, the solve stops at the first iteration after a stop is requested on it
+        *	\param i_stopping Additional stopping criteria, all disabled by default
+        *	\param i_max_npop The maximum size of the population, the storage of the population is allocated once for this size
         *	\return A GA<T> object
         */
         GA(const T& i_x_rate, const T& i_pi, const T& i_alpha, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max, const bool& i_use_penalty_method,
             const Constraints_type& i_constraints_type, const Strategy& i_strategy,
-            const bool& i_print_to_output, const bool& i_print_to_file) :
-            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file),
+            const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {},
+            const size_t& i_max_npop = 1000) :
+            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file, i_seed, i_nthreads, i_trace_capacity, i_time_budget, i_cancellation, i_stopping),
             x_rate(i_x_rate),
             pi(i_pi),
             alpha(i_alpha),
-            strategy(i_strategy)
+            strategy(i_strategy),
+            max_npop(i_max_npop)
         {
             assert(x_rate > 0 && x_rate <= 1);
             assert(pi > 0 && pi <= 1);
+            assert(max_npop >= this->npop);
         }
         /** \brief Natural Selection rate */
         const T x_rate;
@@ -62,32 +128,43 @@ namespace ea
         const T alpha;
         /** \brief Replacing or remove individuals strategies during mutation */
         const Strategy strategy;
+        /** \brief Maximum size of the population */
+        const size_t max_npop;
         /** \brief Type of the algorithm */
         std::string_view type = "Genetic Algorithms";
     };
 
-    /*! \class  Solver<GA, T, F, C>
+    /*! \class  Solver<GA, T, F, C, N>
     *  \brief Genetic Algorithms (GA) Class
     */
-    template<std::floating_point T, typename F, typename C>
-    class Solver<GA, T, F, C> : public Solver_base<Solver<GA, T, F, C>, GA, T, F, C>
+    template<std::floating_point T, typename F, typename C, size_t N>
+    class Solver<GA, T, F, C, N> : public Solver_base<Solver<GA, T, F, C, N>, GA, T, F, C, N>
     {
     public:
-        friend class Solver_base<Solver<GA, T, F, C>, GA, T, F, C>;
-        /*! \fn Solver(const GA<T>& i_ga, const F& f, const C& c)
+        friend class Solver_base<Solver<GA, T, F, C, N>, GA, T, F, C, N>;
+        /*! \fn Solver(const GA<T>& i_ga, const F& f, const C& c, const std::uint64_t& seed)
         *  \brief Constructor
         *  \param i_ga The genetic algorithms parameter structure that is used to construct the solver
         *  \param f A reference to the objective function
         *  \param c A reference to the constraints function
-        *  \return A Solver<GA, T, F, C> object
+        *  \param seed The seed of the random number engine
+        *  \return A Solver<GA, T, F, C, N> object
         */
-        Solver(const GA<T>& i_ga, F f, C c) :
-            Solver_base<Solver<GA, T, F, C>, GA, T, F, C>(i_ga, f, c),
+        Solver(const GA<T>& i_ga, F f, C c, const std::uint64_t& seed) :
+            Solver_base<Solver<GA, T, F, C, N>, GA, T, F, C, N>(i_ga, f, c, seed),
             ga(this->solver_struct),
             npop(i_ga.npop),
             stdev(i_ga.stdev),
-            bdistribution(boost::math::beta_distribution<T>(1, ga.alpha))
+            beta_quantile(boost::math::beta_distribution<T>(1, ga.alpha)),
+            sorted(0, ga.ndv),
+            offspring(make_individual<T, N>(ga.ndv)),
+            mutated(make_individual<T, N>(ga.ndv))
         {
+            //! The population never grows beyond max_npop, so the generations do not allocate
+            this->individuals.reserve(ga.max_npop);
+            sorted.reserve(ga.max_npop);
+            order.reserve(ga.max_npop);
+            pending.reserve(ga.max_npop);
         }
     private:
         /** \brief Genetic Algorithms structure used internally (reference to solver_struct) */
@@ -96,26 +173,39 @@ namespace ea
         size_t npop;
         /** \brief Standard deviation is mutable, so a copy is created */
         std::vector<T> stdev;
-        /** \brief Beta distribution */
-        boost::math::beta_distribution<T> bdistribution;
-        /** \fn crossover(std::vector<T> r, std::vector<T> s)
+        /** \brief Quantile function of the Beta distribution of the ranks of the parents, tabulated once per solve */
+        Quantile_table<T> beta_quantile;
+        /** \brief The individuals kept in each generation, sorted by fitness, reused across generations */
+        Population<T, N> sorted;
+        /** \brief Offspring produced by selection, reused across generations */
+        Individual<T, N> offspring;
+        /** \brief Individual produced by mutation, reused across generations */
+        Individual<T, N> mutated;
+        /** \brief Indices of the individuals that have not been evaluated yet, reused across generations */
+        std::vector<size_t> pending;
+        /** \brief Indices of the individuals in ascending order of fitness, reused across generations */
+        std::vector<size_t> order;
+        /** \fn crossover(std::span<const T, N> r, std::span<const T, N> s, std::span<T, N> offspring)
         *  \brief Crossover step of GA
         *  \param r,s Parent individuals
-        *  \return An offspring from the two parents r and s
+        *  \param offspring The offspring from the two parents r and s, overwritten by this method
+        *  \return void
         */
-        std::vector<T> crossover(std::vector<T> r, std::vector<T> s);
-        /** \fn selection()
+        void crossover(std::span<const T, N> r, std::span<const T, N> s, std::span<T, N> offspring);
+        /** \fn selection(std::span<T, N> offspring)
         *  \brief Selection step of GA
         *  \details Select two parents r and s using a Beta distribution and generates an offspring using the crossover method
-        *  \return An offspring from the two parents
+        *  \param offspring The offspring from the two parents, overwritten by this method
+        *  \return void
         */
-        std::vector<T> selection();
-        /** \fn mutation(const std::vector<T>& individual)
+        void selection(std::span<T, N> offspring);
+        /** \fn mutation(std::span<const T, N> individual, std::span<T, N> mutated)
         *  \brief Mutation step of GA
         *  \param individual An individual of the population
-        *  \return A mutated individual
+        *  \param mutated The mutated individual, overwritten by this method
+        *  \return void
         */
-        std::vector<T> mutation(const std::vector<T>& individual);
+        void mutation(std::span<const T, N> individual, std::span<T, N> mutated);
         /** \fn nkeep()
         *  \brief Returns number of individuals to be kept in each generation
         *  \return The new nkeep
@@ -125,7 +215,13 @@ namespace ea
         *  \brief Runs the algorithm until stopping criteria
         *  return void
         */
-        void run_algo();
+        void run_algo() { this->run_iterations(0, ga.iter_max); }
+        /** \fn iterate(const size_t& iter)
+        *  \brief Runs one iteration of the algorithm
+        *  \param iter The iteration
+        *  \return True if the stopping criteria are met
+        */
+        bool iterate(const size_t& iter);
         /*! \fn display_parameters()
         *  \brief  Display the parameters of GA
         *  \return A std::stringstream of the parameters
@@ -144,132 +240,175 @@ namespace ea
             case Strategy::remove: parameters << "Remove individual"; break;
             default: parameters << "Do nothing"; break;
             }
+            parameters << ",Maximum Population:" << "," << ga.max_npop;
             return parameters;
         }
     };
 
-    template<std::floating_point T, typename F, typename C>
-    std::vector<T> Solver<GA, T, F, C>::crossover(std::vector<T> r, std::vector<T> s)
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<GA, T, F, C, N>::crossover(std::span<const T, N> r, std::span<const T, N> s, std::span<T, N> offspring)
     {
-        std::vector<T> offspring(ga.ndv);
-        std::vector<T> psi(ga.ndv);
-        for (size_t j = 0; j < ga.ndv; ++j)
+        for (size_t j = 0; j < this->dim(); ++j)
         {
-            psi[j] = this->distribution(generator);
-            offspring[j] = psi[j] * r[j] + (1 - psi[j]) * s[j];
+            const T psi = this->distribution(this->generator);
+            offspring[j] = psi * r[j] + (1 - psi) * s[j];
         }
-        return offspring;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    std::vector<T> Solver<GA, T, F, C>::selection()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<GA, T, F, C, N>::selection(std::span<T, N> offspring)
     {
-        //! Generate r and s indices
-        T xi = quantile(bdistribution, this->distribution(generator));
-        size_t r = static_cast<size_t>(std::floor(static_cast<T>(nkeep()) * xi));
-        xi = quantile(bdistribution, this->distribution(generator));
-        size_t s = static_cast<size_t>(std::floor(static_cast<T>(nkeep()) * xi));
+        //! Generate r and s indices, the last kept individual bounds them in case an interpolated quantile rounds to 1
+        const size_t keep = nkeep();
+        T xi = beta_quantile(this->distribution(this->generator));
+        size_t r = std::min(static_cast<size_t>(std::floor(static_cast<T>(keep) * xi)), keep - 1);
+        xi = beta_quantile(this->distribution(this->generator));
+        size_t s = std::min(static_cast<size_t>(std::floor(static_cast<T>(keep) * xi)), keep - 1);
         //! Produce offsrping using r and s indices by crossover
-        std::vector<T> offspring = crossover(this->individuals[r], this->individuals[s]);
-        return offspring;
+        crossover(this->individuals[r], this->individuals[s], offspring);
     }
 
-    template<std::floating_point T, typename F, typename C>
-    std::vector<T> Solver<GA, T, F, C>::mutation(const std::vector<T>& individual)
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<GA, T, F, C, N>::mutation(std::span<const T, N> individual, std::span<T, N> mutated)
     {
-        std::vector<T> mutated = individual;
-        for (size_t j = 0; j < ga.ndv; ++j)
+        for (size_t j = 0; j < this->dim(); ++j)
         {
-            const T r = this->distribution(generator);
+            mutated[j] = individual[j];
+            const T r = this->distribution(this->generator);
             if (ga.pi < r)
             {
                 std::normal_distribution<T> ndistribution(0, stdev[j]);
-                T epsilon = ndistribution(generator);
+                T epsilon = ndistribution(this->generator);
                 mutated[j] = mutated[j] + epsilon;
             }
         }
-        return mutated;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    size_t Solver<GA, T, F, C>::nkeep()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    size_t Solver<GA, T, F, C, N>::nkeep()
     {
         return static_cast<size_t>(std::ceil(static_cast<T>(npop) * ga.x_rate));
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<GA, T, F, C>::run_algo()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<GA, T, F, C, N>::iterate(const size_t& iter)
     {
-        auto comparator = [&](const std::vector<T>& l, const std::vector<T>& r)
-        {
-            return this->f(l) < this->f(r);
-        };
-        for (size_t iter = 0; iter < ga.iter_max; ++iter)
+        //! Offspring are not evaluated until they have been through mutation
+        const T not_evaluated = std::numeric_limits<T>::quiet_NaN();
+        //! Set the new population size which is previous population size + natural selection rate * population size
+        npop = this->individuals.size();
         {
-            //! Set the new population size which is previous population size + natural selection rate * population size
-            npop = this->individuals.size();
-            std::sort(this->individuals.begin(), this->individuals.end(), comparator);
-            this->individuals.erase(this->individuals.begin() + nkeep(), this->individuals.begin() + this->individuals.size());
-            this->min_cost = this->individuals[0];
-            this->last_iter = iter;
-            if (ga.tol > std::abs(this->f(this->min_cost)))
+            Phase_timer phase{ this->counters.selection_time };
+            //! Select the kept individuals with the cached fitness, only the kept prefix is sorted. Ties are broken by index so that the order is deterministic
+            const size_t keep = nkeep();
+            const auto by_fitness = [&](const size_t& l, const size_t& r)
+                {
+                    return this->individuals.fitness(l) < this->individuals.fitness(r) || (this->individuals.fitness(l) == this->individuals.fitness(r) && l < r);
+                };
+            order.resize(npop);
+            std::iota(order.begin(), order.end(), 0);
+            std::nth_element(order.begin(), order.begin() + (keep - 1), order.end(), by_fitness);
+            std::sort(order.begin(), order.begin() + keep, by_fitness);
+            sorted.clear();
+            for (size_t i = 0; i < keep; ++i)
             {
-                this->solved_flag = true;
-                break;
+                sorted.push_back(this->individuals[order[i]], this->individuals.fitness(order[i]));
             }
-            for (size_t i = 0; i < npop; ++i)
+            std::swap(this->individuals, sorted);
+            this->min_cost.assign(this->individuals[0].begin(), this->individuals[0].end());
+            this->min_fitness = this->individuals.fitness(0);
+        }
+        this->last_iter = iter;
+        this->record_iteration(iter);
+        if (ga.tol > std::abs(this->min_fitness))
+        {
+            this->solved_flag = true;
+            return true;
+        }
+        {
+            Phase_timer phase{ this->counters.selection_time };
+            //! The offspring fill the population up to its maximum size
+            const size_t noffspring = std::min(npop, ga.max_npop - this->individuals.size());
+            for (size_t i = 0; i < noffspring; ++i)
             {
-                std::vector<T> offspring = selection();
-                this->individuals.push_back(offspring);
+                selection(offspring);
+                this->individuals.push_back(offspring, not_evaluated);
             }
-            if (this->individuals.size() > 1000)
+        }
+        //! Rejected individuals are removed by compacting the population in place in one pass. As when they were erased one by one,
+        //! the individual that follows a removed one is kept without being mutated in this generation
+        size_t w = 1;
+        const auto keep_unmutated = [&](const size_t& r)
             {
-                //this->individuals.erase(this->individuals.begin() + 1000, this->individuals.begin() + this->individuals.size());
-            }
-            for (size_t i = 1; i < this->individuals.size(); ++i)
+                if (w != r)
+                {
+                    this->individuals.set(w, this->individuals[r], this->individuals.fitness(r));
+                }
+                ++w;
+            };
+        for (size_t r = 1; r < this->individuals.size(); ++r)
+        {
+            mutation(this->individuals[r], mutated);
+            if (!this->check_constraints(mutated))
             {
-                std::vector<T> mutated = mutation(this->individuals[i]);
-                if (!this->c(mutated))
+                switch (ga.strategy)
                 {
-                    switch (ga.strategy)
-                    {
-                    case Strategy::keep_same: this->individuals[i] = this->individuals[i]; break;
-                    case Strategy::re_mutate:
+                case Strategy::keep_same:
+                {
+                    keep_unmutated(r);
+                    break;
+                }
+                case Strategy::re_mutate:
+                {
+                    while (!this->check_constraints(mutated))
                     {
-                        while (!this->c(mutated))
-                        {
-                            mutated = mutation(this->individuals[i]);
-                        }
-                        break;
-                        this->individuals[i] = mutated;
+                        ++this->counters.resamples;
+                        mutation(this->individuals[r], mutated);
                     }
-                    case Strategy::remove:
+                    //! The first feasible mutant replaces the individual
+                    this->individuals.set(w, mutated, not_evaluated);
+                    ++w;
+                    break;
+                }
+                case Strategy::remove:
+                {
+                    if (++r < this->individuals.size())
                     {
-                        if (i == this->individuals.size() - 1)
-                        {
-                            this->individuals.pop_back();
-                        }
-                        else
-                        {
-                            this->individuals.erase(this->individuals.begin() + i);
-                        }
-                        break;
-                    }
-                    case Strategy::none: break;
-                    default: std::abort();
+                        keep_unmutated(r);
                     }
+                    break;
                 }
-                else
+                case Strategy::none:
                 {
-                    this->individuals[i] = mutated;
+                    keep_unmutated(r);
+                    break;
+                }
+                default: std::abort();
                 }
             }
-            //! Standard Deviation is not constant in GA
-            for (auto& p : stdev)
+            else
             {
-                p = p + 0.02 * p;
+                this->individuals.set(w, mutated, not_evaluated);
+                ++w;
             }
         }
+        this->individuals.resize(w);
+        //! Evaluate the mutated individuals and the offspring that were kept unmutated as one batch
+        pending.clear();
+        for (size_t i = 1; i < this->individuals.size(); ++i)
+        {
+            if (std::isnan(this->individuals.fitness(i)))
+            {
+                pending.push_back(i);
+            }
+        }
+        this->evaluate_population(this->individuals, pending);
+        //! Standard Deviation is not constant in GA
+        for (auto& p : stdev)
+        {
+            p = p + 0.02 * p;
+        }
+        return false;
     }
 
 }
\ No newline at end of file
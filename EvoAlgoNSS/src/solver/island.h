@@ -0,0 +1,309 @@
+/** \file island.h
+* \author Ioannis Anagnostopoulos
+* \brief Island model: independent populations of a solver that run in parallel and exchange their best individuals
+*/
+
+#pragma once
+
+#include <memory>
+#include "ealgorithm_base.h"
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /** \enum Topology
+    *  \brief The islands each island sends its migrants to
+    */
+    enum class Topology { ring, fully_connected };
+
+    /** \struct Islands
+    *  \brief Island model parameter structure
+    */
+    struct Islands
+    {
+    public:
+        /** \fn Islands(const size_t& i_nislands, const size_t& i_migration_interval, const size_t& i_nmigrants, const Topology& i_topology, const size_t& i_nthreads)
+        *  \brief Constructor
+        *  \param i_nislands The number of islands
+        *  \param i_migration_interval The number of iterations between migrations
+        *  \param i_nmigrants The number of individuals each island sends to each of its destinations
+        *  \param i_topology The destinations of the migrants, the next island for a ring and every other island when fully connected
+        *  \param i_nthreads The number of threads the islands run on
+        *  \return An Islands object
+        */
+        Islands(const size_t& i_nislands, const size_t& i_migration_interval, const size_t& i_nmigrants, const Topology& i_topology = Topology::ring, const size_t& i_nthreads = 1)
+            : nislands{ i_nislands }, migration_interval{ i_migration_interval }, nmigrants{ i_nmigrants }, topology{ i_topology }, nthreads{ i_nthreads }
+        {
+            assert(nislands > 0);
+            assert(migration_interval > 0);
+        }
+        /** \brief Number of islands */
+        const size_t nislands;
+        /** \brief Number of iterations between migrations */
+        const size_t migration_interval;
+        /** \brief Number of individuals each island sends to each of its destinations */
+        const size_t nmigrants;
+        /** \brief Destinations of the migrants */
+        const Topology topology;
+        /** \brief Number of threads the islands run on */
+        const size_t nthreads;
+    };
+
+    /*! \class Island_solver
+    *  \brief Runs one solver per island on a thread pool and migrates the best individuals between the islands
+    *  \details The islands run in epochs of migration_interval iterations. An epoch runs every island in parallel, then each island sends
+    *  copies of its nmigrants best individuals to its destinations, where they replace the worst individuals they are better than.
+    *  The migrants of an epoch are all taken before any of them arrives, so the result does not depend on the order of the islands.
+    *  The solve stops at the end of the epoch in which an island meets its tolerance or one of its additional stopping criteria, or is stopped
+    *  by the cancellation token or the time budget of the parameter structure. Island k is seeded with derive_seed(seed, k),
+    *  so a solve is reproducible for a given seed whatever the number of threads. The islands already run in parallel,
+    *  so the nthreads of the parameter structure of the solver should be 1. The root finder has a single individual and is not supported.
+    *  Every island times its epochs as solver_bench times a solve, and the times of the phases are summed over the islands.
+    */
+    template<template<typename> class S, std::floating_point T, typename F, typename C, size_t N = std::dynamic_extent>
+    class Island_solver
+    {
+    public:
+        /*! \fn Island_solver(const Islands& i_islands, const S<T>& i_solver_struct, const F& f, const C& c, const std::uint64_t& seed)
+        *  \brief Constructor, initialises the populations of the islands in parallel
+        *  \param i_islands The island model parameter structure
+        *  \param i_solver_struct The parameter structure of the solver of every island
+        *  \param f The objective function
+        *  \param c The constraints function
+        *  \param seed The seed the seeds of the islands are derived from
+        *  \return An Island_solver<S, T, F, C, N> object
+        */
+        Island_solver(const Islands& i_islands, const S<T>& i_solver_struct, const F& f, const C& c, const std::uint64_t& seed) :
+            islands{ i_islands },
+            solver_struct{ i_solver_struct },
+            pool{ std::min(i_islands.nthreads, i_islands.nislands) },
+            solvers(i_islands.nislands),
+            migrants(i_islands.nislands, Population<T, N>(0, i_solver_struct.ndv)),
+            timer{ 0 }
+        {
+            pool.parallel_for(solvers.size(), [&](const size_t& k)
+                {
+                    solvers[k] = std::make_unique<Solver<S, T, F, C, N>>(solver_struct, f, c, derive_seed(seed, k));
+                });
+        }
+        /*! \fn solver_bench(std::string_view problem_name, std::ostream& output)
+        *  \brief Runs the islands until an island meets its stopping criteria or the maximum number of iterations is reached
+        *  \param problem_name The name of the problem in std::string form, used to print results to file
+        *  \param output The stream the results are printed to when print_to_output is set
+        *  \return The best solution of the islands and its fitness, with the counters summed over the islands
+        */
+        Result<T> solver_bench(std::string_view problem_name, std::ostream& output = std::cout);
+    private:
+        /** \brief Island model parameter structure */
+        const Islands& islands;
+        /** \brief Parameter structure of the solver of every island */
+        const S<T>& solver_struct;
+        /** \brief Threads the islands run on */
+        Thread_pool pool;
+        /** \brief The solvers of the islands, a solver owns a thread pool and is neither copyable nor movable */
+        std::vector<std::unique_ptr<Solver<S, T, F, C, N>>> solvers;
+        /** \brief Migrants sent by each island, reused across migrations */
+        std::vector<Population<T, N>> migrants;
+        /** \brief Duration of the solve in seconds */
+        double timer;
+        /*! \fn migrate()
+        *  \brief Sends the best individuals of every island to its destinations
+        *  \return void
+        */
+        void migrate();
+        /*! \fn best_island() const
+        *  \return The index of the island with the best solution
+        */
+        size_t best_island() const;
+        /*! \fn display_results(const Result<T>& result)
+        *  \brief Display the results of the island model as well as its parameters and the parameters of the solver
+        *  \param result The result of the solve
+        *  \return A std::stringstream of the results
+        */
+        std::stringstream display_results(const Result<T>& result);
+    };
+
+    template<template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    Result<T> Island_solver<S, T, F, C, N>::solver_bench(std::string_view problem_name, std::ostream& output)
+    {
+        const std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+        for (const auto& p : solvers)
+        {
+            p->start_solve();
+        }
+        //! An island may already be solved by its initial population
+        bool solved = solver_struct.tol > std::abs(solvers[best_island()]->best_fitness());
+        Stop_reason reason = solved ? Stop_reason::tolerance : Stop_reason::max_iterations;
+        for (size_t first = 0; first < solver_struct.iter_max && reason == Stop_reason::max_iterations; first += islands.migration_interval)
+        {
+            const size_t last = std::min(first + islands.migration_interval, solver_struct.iter_max);
+            pool.parallel_for(solvers.size(), [&](const size_t& k)
+                {
+                    solvers[k]->run_timed_iterations(first, last);
+                });
+            //! An island that stopped early stops the model at the end of the epoch, a solved island takes precedence
+            for (const auto& p : solvers)
+            {
+                solved = solved || p->solved();
+                if (p->stop_reason() != Stop_reason::max_iterations && reason != Stop_reason::tolerance)
+                {
+                    reason = p->stop_reason();
+                }
+            }
+            if (reason == Stop_reason::max_iterations && last < solver_struct.iter_max)
+            {
+                migrate();
+            }
+        }
+        const std::chrono::duration<double> elapsed_seconds = std::chrono::steady_clock::now() - start;
+        timer = elapsed_seconds.count();
+        //! The solution is the best of the islands, the work is the sum of the work of the islands
+        Result<T> result = solvers[best_island()]->result();
+        result.solved = solved;
+        result.reason = reason;
+        result.elapsed_time = timer;
+        result.counters = Counters{};
+        for (const auto& p : solvers)
+        {
+            result.last_iter = std::max(result.last_iter, p->iteration_count());
+            result.counters += p->solve_counters();
+        }
+        if (!solver_struct.print_to_output && !solver_struct.print_to_file)
+        {
+            return result;
+        }
+        std::string results = display_results(result).str();
+        if (solver_struct.print_to_output)
+        {
+            output << results;
+        }
+        else {};
+        if (solver_struct.print_to_file)
+        {
+            std::string filename;
+            filename.append(problem_name);
+            filename.append("-results.csv");
+            Results_sink::instance().submit(std::move(filename), std::move(results));
+        }
+        else {};
+        return result;
+    }
+
+    template<template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    void Island_solver<S, T, F, C, N>::migrate()
+    {
+        for (size_t k = 0; k < solvers.size(); ++k)
+        {
+            solvers[k]->emigrants(islands.nmigrants, migrants[k]);
+        }
+        for (size_t k = 0; k < solvers.size(); ++k)
+        {
+            switch (islands.topology)
+            {
+            case(Topology::ring):
+            {
+                solvers[(k + 1) % solvers.size()]->immigrate(migrants[k]);
+                break;
+            }
+            case(Topology::fully_connected):
+            {
+                for (size_t j = 0; j < solvers.size(); ++j)
+                {
+                    if (j != k)
+                    {
+                        solvers[j]->immigrate(migrants[k]);
+                    }
+                }
+                break;
+            }
+            }
+        }
+    }
+
+    template<template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    size_t Island_solver<S, T, F, C, N>::best_island() const
+    {
+        size_t best = 0;
+        for (size_t k = 1; k < solvers.size(); ++k)
+        {
+            if (solvers[k]->best_fitness() < solvers[best]->best_fitness())
+            {
+                best = k;
+            }
+        }
+        return best;
+    }
+
+    template<template<typename> class S, std::floating_point T, typename F, typename C, size_t N>
+    std::stringstream Island_solver<S, T, F, C, N>::display_results(const Result<T>& result)
+    {
+        std::stringstream results;
+        results << "Algorithm:" << "," << "Island Model" << "," << "Solved:" << ",";
+        if (!result.solved)
+        {
+            results << "False" << ",";
+        }
+        else
+        {
+            results << "True" << ",";
+        }
+        results << "Stop Reason:" << "," << stop_reason_name(result.reason) << ",";
+        results << "Solution:" << "," << result.min_cost << ",";
+        results << "Fitness:" << "," << result.min_fitness << ",";
+        results << "Iterations:" << "," << result.last_iter << ",";
+        results << "Evaluations:" << "," << result.counters.evaluations << ",";
+        results << "Elapsed Time:" << "," << result.elapsed_time << ",";
+        results << "Initialisation Time:" << "," << result.counters.init_time << ",";
+        results << "Evaluation Time:" << "," << result.counters.evaluation_time << ",";
+        results << "Other Time:" << "," << result.counters.other_time << ",";
+        results << "Selection Time:" << "," << result.counters.selection_time << ",";
+        results << "Islands:" << "," << islands.nislands << ",";
+        results << "Migration Interval:" << "," << islands.migration_interval << ",";
+        results << "Migrants:" << "," << islands.nmigrants << ",";
+        results << "Topology:" << ",";
+        switch (islands.topology)
+        {
+        case(Topology::ring): results << "Ring" << ","; break;
+        case(Topology::fully_connected): results << "Fully Connected" << ","; break;
+        }
+        results << "Threads:" << "," << pool.size() << ",";
+        results << "Island Algorithm:" << "," << solver_struct.type << ",";
+        results << "Initial Population:" << "," << solver_struct.npop << ",";
+        results << "Tolerance:" << "," << solver_struct.tol << ",";
+        results << "Maximum Iterations:" << "," << solver_struct.iter_max << "\n";
+        return results;
+    }
+
+    /*! \fn solve_islands(const F& f, const C& c, const S<T>& solver_struct, const Islands& islands, std::string_view problem_name, const std::uint64_t& seed, std::ostream& output)
+    *  \brief Island model wrapper function, the number of decision variables N can be given explicitly as for solve()
+    *  \param f The objective function
+    *  \param c The constraints function
+    *  \param solver_struct The parameter structure of the solver of every island
+    *  \param islands The island model parameter structure
+    *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
+    *  \param seed The seed the seeds of the islands are derived from
+    *  \param output The stream the results are printed to when print_to_output is set
+    *  \return The best solution of the islands, its fitness and the counters summed over the islands
+    */
+    template<size_t N = std::dynamic_extent, typename F, typename C, template<typename> class S, std::floating_point T>
+    Result<T> solve_islands(const F& f, const C& c, const S<T>& solver_struct, const Islands& islands, std::string_view problem_name, const std::uint64_t& seed, std::ostream& output = std::cout)
+    {
+        Island_solver<S, T, F, C, N> solver{ islands, solver_struct, f, c, seed };
+        return solver.solver_bench(problem_name, output);
+    }
+
+    /*! \fn solve_islands(const F& f, const C& c, const S<T>& solver_struct, const Islands& islands, std::string_view problem_name)
+    *  \brief Island model wrapper function using the seed of the parameter structure
+    *  \param f The objective function
+    *  \param c The constraints function
+    *  \param solver_struct The parameter structure of the solver of every island
+    *  \param islands The island model parameter structure
+    *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
+    *  \return The best solution of the islands, its fitness and the counters summed over the islands
+    */
+    template<size_t N = std::dynamic_extent, typename F, typename C, template<typename> class S, std::floating_point T>
+    Result<T> solve_islands(const F& f, const C& c, const S<T>& solver_struct, const Islands& islands, std::string_view problem_name)
+    {
+        return solve_islands<N>(f, c, solver_struct, islands, problem_name, solver_struct.seed);
+    }
+}
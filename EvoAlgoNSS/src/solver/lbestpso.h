@@ -5,7 +5,6 @@
 
 #pragma once
 
-#include <unordered_map>
 #include <boost/math/constants/constants.hpp>
 #include <array>
 #include "ealgorithm_base.h"
@@ -22,7 +21,9 @@ namespace ea
         /** \fn PSOl(const T& i_c, const T& i_w, const std::vector<T>& i_vmax, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
         const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
         const bool& i_use_penalty_method = false, const Constraints_type& i_constraints_type = Constraints_type::none,
-        const bool& i_print_to_output = true, const bool& i_print_to_file = true)
+        const bool& i_print_to_output = true, const bool& i_print_to_file = true, const std::uint64_t& i_seed = default_seed,
+        const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+        const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {})
         \brief Constructor
         \param i_c c parameter for velocity update
         \param i_w Inertia parameter for velocity update
@@ -36,13 +37,21 @@ namespace ea
         \param i_constraints_type What kind of constraints to use
         \param i_print_to_output Whether to print to terminal or not
         \param i_print_to_file Whether to print to a file or not
+        \param i_seed The seed of the random number engine of the solver
+        \param i_nthreads The number of threads used to evaluate the particles
+        \param i_trace_capacity The number of iterations kept by the convergence trace, 0 disables it
+        \param i_time_budget The wall-clock time in seconds the solve may take from the construction of the solver, 0 for no limit
+        \param i_cancellation A stop token, the solve stops at the first iteration after a stop is requested on it
+        \param i_stopping Additional stopping criteria, all disabled by default
         \return A PSOl<T> object
         */
         PSOl(const T& i_c, const T& i_w, const std::vector<T>& i_vmax, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
             const bool& i_use_penalty_method, const Constraints_type& i_constraints_type,
-            const bool& i_print_to_output, const bool& i_print_to_file) :
-            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file),
+            const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {}) :
+            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file, i_seed, i_nthreads, i_trace_capacity, i_time_budget, i_cancellation, i_stopping),
             c(i_c),
             w(i_w),
             vmax(i_vmax)
@@ -62,54 +71,44 @@ namespace ea
         std::string_view type = "Local Best Particle Swarm Optimisation";
     };
 
-    /*! \class Solver<PSOl, T, F, C>
+    /*! \class Solver<PSOl, T, F, C, N>
     *  \brief Local Best Particle Swarm Optimisation (PSO) Class
     */
-    template<std::floating_point T, typename F, typename C>
-    class Solver<PSOl, T, F, C> : public Solver_base<Solver<PSOl, T, F, C>, PSOl, T, F, C>
+    template<std::floating_point T, typename F, typename C, size_t N>
+    class Solver<PSOl, T, F, C, N> : public Solver_base<Solver<PSOl, T, F, C, N>, PSOl, T, F, C, N>
     {
     public:
-        friend class Solver_base<Solver<PSOl, T, F, C>, PSOl, T, F, C>;
-        /*! \fn Solver(const PSO<T>& i_pso, F f, C c)
+        friend class Solver_base<Solver<PSOl, T, F, C, N>, PSOl, T, F, C, N>;
+        /*! \fn Solver(const PSO<T>& i_pso, F f, C c, const std::uint64_t& seed)
         *  \brief Constructor
         *  \param i_pso The particle swarm optimisation parameter structure that is used to construct the solver
         *  \param f A reference to the objective function
         *  \param c A reference to the constraints function
+        *  \param seed The seed of the random number engine
         *  \return A Solver<PSO, T, F, C> object
         */
-        Solver(const PSOl<T>& i_pso, F f, C c) :
-            Solver_base<Solver<PSOl, T, F, C>, PSOl, T, F, C>(i_pso, f, c),
+        Solver(const PSOl<T>& i_pso, F f, C c, const std::uint64_t& seed) :
+            Solver_base<Solver<PSOl, T, F, C, N>, PSOl, T, F, C, N>(i_pso, f, c, seed),
             pso(this->solver_struct),
             w(i_pso.w),
             vmax(i_pso.vmax),
+            personal_best(this->individuals),
+            local_best(i_pso.npop, i_pso.ndv),
+            velocity(i_pso.npop, i_pso.ndv),
             nneigh(i_pso.npop),
             neighbours(set_neighbourhoods())
         {
-            velocity.resize(pso.npop, std::vector<T>(pso.ndv));
-            local_best.resize(nneigh);
-            for (auto& p : velocity)
+            for (size_t i = 0; i < nneigh; ++i)
             {
-                for (auto& n : p)
-                {
-                    n = 0.0;
-                }
-            }
-            for (const auto& p : this->individuals)
-            {
-                personal_best.push_back(p);
-                personal_best_cost.push_back(f(p));
-            }
-            for (auto& p : local_best)
-            {
-                p = personal_best[0];
+                local_best.set(i, personal_best[0], personal_best.fitness(0));
             }
             for (size_t i = 0; i < pso.npop; ++i)
             {
                 for (const auto& index : neighbours[i])
                 {
-                    if (personal_best_cost[index] < this->f(local_best[i]))
+                    if (personal_best.fitness(index) < local_best.fitness(i))
                     {
-                        local_best[i] = personal_best[index];
+                        local_best.set(i, personal_best[index], personal_best.fitness(index));
                     }
                 }
             }
@@ -122,25 +121,52 @@ namespace ea
         T w;
         /** \brief Maximum Velocity is mutable, so a copy is created */
         std::vector<T> vmax;
-        /** \brief Personal best vector of the particles, holds the best position recorded for each particle */
-        std::vector<std::vector<T>> personal_best;
-        /** \brief Personal best cost vector of the particles */
-        std::vector<T> personal_best_cost;
-        /** \brief Local best vector, holds the best position recorded for each neighbourhood */
-        std::vector<std::vector<T>> local_best;
-        /** \brief Velocity of the particles */
-        std::vector<std::vector<T>> velocity;
+        /** \brief Personal best of the particles, holds the best position and cost recorded for each particle */
+        Population<T, N> personal_best;
+        /** \brief Local best, holds the best position and cost recorded for each neighbourhood */
+        Population<T, N> local_best;
+        /** \brief Velocity of the particles, the fitness column is not used */
+        Population<T, N> velocity;
         /** \brief Number of neighbourhoods */
         const size_t nneigh;
         /** \brief Neighbours of each particle */
-        std::unordered_map<size_t, std::array<size_t, 3>> neighbours;
+        std::vector<std::array<size_t, 3>> neighbours;
+        /** \brief Indices of the particles that moved to a feasible position and have not been evaluated yet */
+        std::vector<size_t> pending;
         /** \fn set_neighbourhoods
         *  \brief Set the neighbourhoods of the algorithm using particle indices
-        *  \return A map matching particle indices to neighbourhoods
+        *  \return A vector matching particle indices to neighbourhoods
+        */
+        std::vector<std::array<size_t, 3>> set_neighbourhoods();
+        /** \fn move_particle(const size_t& i)
+        *  \brief Updates the velocity and position of a particle, an infeasible particle is moved back to its personal best
+        *  \param i The index of the particle
+        *  \return true if the particle moved to a feasible position and has to be evaluated, false otherwise
+        */
+        bool move_particle(const size_t& i);
+        /** \fn update_best(const size_t& i)
+        *  \brief Updates the personal best of a particle and the local best of its neighbourhood
+        *  \param i The index of the particle
+        *  \return void
+        */
+        void update_best(const size_t& i);
+        /** \fn accept_immigrant(const size_t& i)
+        *  \brief Updates the personal best of a particle replaced by a migrant and the local bests of the neighbourhoods it belongs to
+        *  \param i The index of the particle
+        *  \return void
         */
-        std::unordered_map<size_t, std::array<size_t, 3>> set_neighbourhoods();
+        void accept_immigrant(const size_t& i)
+        {
+            for (const auto& index : neighbours[i])
+            {
+                update_best(index);
+            }
+        }
         /** \fn position_update()
         *  \brief Position update of the particles
+        *  \details All particles move first, the feasible ones are evaluated as one batch (in parallel when the solver uses more than one thread)
+        *  and then the bests are updated in particle order. This gives the same result as evaluating each particle as soon as it moves,
+        *  since a particle moves using only bests that are updated at its own step.
         *  \return void
         */
         void position_update();
@@ -155,7 +181,7 @@ namespace ea
         */
         void find_min_local_best();
         /** \fn check_pso_criteria
-        *  \brief Define the maximum radius stopping criterion
+        *  \brief The tolerance stopping criterion, the maximum radius of the swarm is one of the shared Stopping_criteria
         *  \return true if criteria are met, false otherwise
         */
         bool check_pso_criteria();
@@ -163,21 +189,13 @@ namespace ea
         *  \brief Runs the algorithm until stopping criteria
         *  return void
         */
-        void run_algo();
-        /** \fn euclid_distance
-        *  \brief Euclidean Distance of two vectors
-        *..\param x,y The two vectors for which the distance is calculated
-        *  \return Distance as a floating-point number
+        void run_algo() { this->run_iterations(0, pso.iter_max); }
+        /** \fn iterate(const size_t& iter)
+        *  \brief Runs one iteration of the algorithm
+        *  \param iter The iteration
+        *  \return True if the stopping criteria are met
         */
-        T euclid_distance(const std::vector<T>& x, const std::vector<T>& y)
-        {
-            T sum = 0;
-            for (size_t i = 0; i < x.size(); ++i)
-            {
-                sum = sum + std::pow(x[i] - y[i], 2);
-            }
-            return std::sqrt(sum);
-        }
+        bool iterate(const size_t& iter);
         /*! \fn display_parameters()
         *  \brief Display PSO parameters
         *  \return A std::stringstream of the parameters
@@ -192,10 +210,10 @@ namespace ea
         }
     };
 
-    template<std::floating_point T, typename F, typename C>
-    std::unordered_map<size_t, std::array<size_t, 3>> Solver<PSOl, T, F, C>::set_neighbourhoods()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    std::vector<std::array<size_t, 3>> Solver<PSOl, T, F, C, N>::set_neighbourhoods()
     {
-        std::unordered_map<size_t, std::array<size_t, 3>> neighbours;
+        std::vector<std::array<size_t, 3>> neighbours(pso.npop);
         for (size_t i = 0; i < pso.npop; ++i)
         {
             if (i == 0)
@@ -217,117 +235,119 @@ namespace ea
         return neighbours;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOl, T, F, C>::position_update()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<PSOl, T, F, C, N>::move_particle(const size_t& i)
     {
-        for (size_t i = 0; i < pso.npop; ++i)
+        const auto x = this->individuals[i];
+        const auto v = velocity[i];
+        const auto p = personal_best[i];
+        const auto l = local_best[i];
+        for (size_t j = 0; j < this->dim(); ++j)
         {
-            for (size_t j = 0; j < pso.ndv; ++j)
-            {
-                std::uniform_real_distribution<double> c(0, pso.c);
-                velocity[i][j] = w * velocity[i][j] + c(generator) * (personal_best[i][j] - this->individuals[i][j])
-                    + c(generator) * (local_best[i][j] - this->individuals[i][j]);
-                if (velocity[i][j] > vmax[j])
-                {
-                    velocity[i][j] = vmax[j];
-                }
-                this->individuals[i][j] = this->individuals[i][j] + velocity[i][j];
-            }
-            //! Checks that the candidate is feasible
-            if (!this->c(this->individuals[i]))
-            {
-                this->individuals[i] = personal_best[i];
-            }
-            if (this->f(this->individuals[i]) < this->f(personal_best[i]))
-            {
-                personal_best[i] = this->individuals[i];
-                personal_best_cost[i] = this->f(this->individuals[i]);
-            }
-            for (const auto& index : neighbours[i])
+            std::uniform_real_distribution<double> c(0, pso.c);
+            v[j] = w * v[j] + c(this->generator) * (p[j] - x[j])
+                + c(this->generator) * (l[j] - x[j]);
+            if (v[j] > vmax[j])
             {
-                if (personal_best_cost[index] < this->f(local_best[i]))
-                {
-                    local_best[i] = personal_best[index];
-                }
+                v[j] = vmax[j];
             }
+            x[j] = x[j] + v[j];
         }
+        //! Checks that the candidate is feasible
+        if (!this->check_constraints(x))
+        {
+            this->individuals.set(i, p, personal_best.fitness(i));
+            return false;
+        }
+        return true;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOl, T, F, C>::best_update()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOl, T, F, C, N>::update_best(const size_t& i)
     {
-        for (size_t i = 0; i < pso.npop; ++i)
+        if (this->individuals.fitness(i) < personal_best.fitness(i))
         {
+            personal_best.set(i, this->individuals[i], this->individuals.fitness(i));
+        }
+        for (const auto& index : neighbours[i])
+        {
+            if (personal_best.fitness(index) < local_best.fitness(i))
+            {
+                local_best.set(i, personal_best[index], personal_best.fitness(index));
+            }
         }
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOl, T, F, C>::find_min_local_best()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOl, T, F, C, N>::position_update()
     {
-        for (size_t k = 0; k < nneigh; ++k)
+        pending.clear();
+        for (size_t i = 0; i < pso.npop; ++i)
         {
-            if (this->f(local_best[k]) < this->f(this->min_cost))
+            if (move_particle(i))
             {
-                this->min_cost = local_best[k];
+                pending.push_back(i);
             }
         }
+        this->evaluate_population(this->individuals, pending);
+        best_update();
     }
 
-    template<std::floating_point T, typename F, typename C>
-    bool Solver<PSOl, T, F, C>::check_pso_criteria()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOl, T, F, C, N>::best_update()
     {
-        std::vector<T> distance(pso.npop);
+        Phase_timer phase{ this->counters.selection_time };
         for (size_t i = 0; i < pso.npop; ++i)
         {
-            distance[i] = euclid_distance(this->individuals[i], this->min_cost);
+            update_best(i);
         }
-        T rmax = distance[0];
-        for (size_t i = 0; i < pso.npop; ++i)
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOl, T, F, C, N>::find_min_local_best()
+    {
+        Phase_timer phase{ this->counters.selection_time };
+        for (size_t k = 0; k < nneigh; ++k)
         {
-            if (rmax < distance[i])
+            if (local_best.fitness(k) < this->min_fitness)
             {
-                rmax = distance[i];
+                this->min_cost.assign(local_best[k].begin(), local_best[k].end());
+                this->min_fitness = local_best.fitness(k);
             }
-            else
-            {
-            }
-        }
-        if (pso.tol > std::abs(this->f(this->min_cost)))// || rmax < pso.tol)
-        {
-            return true;
-        }
-        else
-        {
-            return false;
         }
     }
 
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<PSOl, T, F, C, N>::check_pso_criteria()
+    {
+        return pso.tol > std::abs(this->min_fitness);
+    }
+
     /** \brief Inverse square of pi constant */
     template<std::floating_point T>
     const double inv_pi_sq = 1 / std::pow(boost::math::constants::pi<T>(), 2);
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOl, T, F, C>::run_algo()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<PSOl, T, F, C, N>::iterate(const size_t& iter)
     {
         //! Local Best Particle Swarm starts here
-        for (size_t iter = 0; iter < pso.iter_max; ++iter)
+        position_update();
+        //best_update();
+        find_min_local_best();
+        //! Inertia weight is updated - Linear
+        //w = pso.w - (pso.w - 0.4) * (static_cast<T>(iter) / static_cast<T>(pso.iter_max));
+        //! Non-linear
+        w = pso.w - (pso.w - 0.4) * std::pow((static_cast<T>(iter) / static_cast<T>(pso.iter_max)), inv_pi_sq<T>);
+        //w = 0.729;
+        //w = 0.5 + distribution(generator) / 2;
+        this->last_iter = iter;
+        this->record_iteration(iter);
+        if (check_pso_criteria())
         {
-            position_update();
-            //best_update();
-            find_min_local_best();
-            //! Inertia weight is updated - Linear
-            //w = pso.w - (pso.w - 0.4) * (static_cast<T>(iter) / static_cast<T>(pso.iter_max));
-            //! Non-linear
-            w = pso.w - (pso.w - 0.4) * std::pow((static_cast<T>(iter) / static_cast<T>(pso.iter_max)), inv_pi_sq<T>);
-            //w = 0.729;
-            //w = 0.5 + distribution(generator) / 2;
-            this->last_iter = iter;
-            if (check_pso_criteria())
-            {
-                this->solved_flag = true;
-                break;
-            }
+            this->solved_flag = true;
+            return true;
         }
+        return false;
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+/** \file population.h
+* \author Ioannis Anagnostopoulos
+* \brief Contiguous storage for the populations of the solvers
+*/
+
+#pragma once
+
+#include <vector>
+#include <array>
+#include <span>
+#include <type_traits>
+#include <concepts>
+#include <algorithm>
+#include <assert.h>
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /** \brief A single candidate solution outside of a population: a std::array when the number of decision variables N is known at compile time,
+    *  a std::vector otherwise
+    */
+    template<std::floating_point T, size_t N>
+    using Individual = std::conditional_t<N == std::dynamic_extent, std::vector<T>, std::array<T, N>>;
+
+    /** \fn make_individual(const size_t& ndv)
+    *  \brief Creates an individual with all decision variables set to zero
+    *  \param ndv The number of decision variables, it has to be equal to N when N is known at compile time
+    *  \return An Individual<T, N> object
+    */
+    template<std::floating_point T, size_t N>
+    Individual<T, N> make_individual(const size_t& ndv)
+    {
+        if constexpr (N == std::dynamic_extent)
+        {
+            return std::vector<T>(ndv);
+        }
+        else
+        {
+            assert(ndv == N);
+            return {};
+        }
+    }
+
+    /*! \class Population
+    *  \brief A population of candidate solutions stored in one contiguous row-major buffer, together with a fitness column
+    *  \details Individual i occupies the positions [i * ndv, (i + 1) * ndv) of the buffer and is accessed through a std::span,
+    *  so that a population of any size is a single allocation and the inner loops of the solvers run over contiguous memory.
+    *  Populations that do not need the fitness column (for example the velocities of PSO) simply ignore it.
+    *  When the number of decision variables N is known at compile time the rows are fixed-size spans, so that the loops over
+    *  the decision variables can be unrolled by the compiler.
+    */
+    template<std::floating_point T, size_t N = std::dynamic_extent>
+    class Population
+    {
+    public:
+        /** \fn Population(const size_t& i_npop, const size_t& i_ndv)
+        *  \brief Constructor
+        *  \param i_npop The number of individuals
+        *  \param i_ndv The number of decision variables of each individual, it has to be equal to N when N is known at compile time
+        *  \return A Population<T, N> object with all positions and fitness values set to zero
+        */
+        Population(const size_t& i_npop, const size_t& i_ndv) :
+            ndv{ i_ndv },
+            positions(i_npop * i_ndv),
+            costs(i_npop)
+        {
+            assert(ndv > 0);
+            assert(N == std::dynamic_extent || ndv == N);
+        }
+        /** \fn operator[](const size_t& i)
+        *  \brief Access to an individual
+        *  \param i The index of the individual
+        *  \return A view of the decision variables of the individual
+        */
+        std::span<T, N> operator[](const size_t& i)
+        {
+            assert(i < size());
+            return std::span<T, N>(positions.data() + i * dim(), dim());
+        }
+        /** \fn operator[](const size_t& i) const
+        *  \brief Read-only access to an individual
+        *  \param i The index of the individual
+        *  \return A read-only view of the decision variables of the individual
+        */
+        std::span<const T, N> operator[](const size_t& i) const
+        {
+            assert(i < size());
+            return std::span<const T, N>(positions.data() + i * dim(), dim());
+        }
+        /** \fn fitness(const size_t& i)
+        *  \brief Access to the fitness of an individual
+        *  \param i The index of the individual
+        *  \return A reference to the fitness of the individual
+        */
+        T& fitness(const size_t& i)
+        {
+            assert(i < size());
+            return costs[i];
+        }
+        /** \fn fitness(const size_t& i) const
+        *  \brief Read-only access to the fitness of an individual
+        *  \param i The index of the individual
+        *  \return The fitness of the individual
+        */
+        const T& fitness(const size_t& i) const
+        {
+            assert(i < size());
+            return costs[i];
+        }
+        /** \fn data() const
+        *  \brief Read-only access to the decision variables of all individuals
+        *  \return A view of the row-major buffer of the population
+        */
+        std::span<const T> data() const { return positions; }
+        /** \fn fitness()
+        *  \brief Access to the fitness column
+        *  \return A view of the fitness of all individuals
+        */
+        std::span<T> fitness() { return costs; }
+        /** \fn size() const
+        *  \brief Number of individuals
+        *  \return The number of individuals in the population
+        */
+        size_t size() const { return costs.size(); }
+        /** \fn dim() const
+        *  \brief Number of decision variables
+        *  \return The number of decision variables of each individual
+        */
+        constexpr size_t dim() const
+        {
+            if constexpr (N == std::dynamic_extent)
+            {
+                return ndv;
+            }
+            else
+            {
+                return N;
+            }
+        }
+        /** \fn set(const size_t& i, std::span<const T> individual, const T& cost)
+        *  \brief Overwrites an individual and its fitness
+        *  \param i The index of the individual
+        *  \param individual The new decision variables
+        *  \param cost The fitness of the new decision variables
+        *  \return void
+        */
+        void set(const size_t& i, std::span<const T> individual, const T& cost)
+        {
+            assert(individual.size() == dim());
+            std::copy(individual.begin(), individual.end(), (*this)[i].begin());
+            costs[i] = cost;
+        }
+        /** \fn push_back(std::span<const T> individual, const T& cost)
+        *  \brief Appends an individual to the population
+        *  \param individual The decision variables of the individual
+        *  \param cost The fitness of the individual
+        *  \return void
+        */
+        void push_back(std::span<const T> individual, const T& cost)
+        {
+            assert(individual.size() == dim());
+            positions.insert(positions.end(), individual.begin(), individual.end());
+            costs.push_back(cost);
+        }
+        /** \fn pop_back()
+        *  \brief Removes the last individual of the population
+        *  \return void
+        */
+        void pop_back()
+        {
+            assert(size() > 0);
+            positions.resize(positions.size() - dim());
+            costs.pop_back();
+        }
+        /** \fn erase(const size_t& i)
+        *  \brief Removes an individual, keeping the order of the rest of the population
+        *  \param i The index of the individual
+        *  \return void
+        */
+        void erase(const size_t& i)
+        {
+            assert(i < size());
+            positions.erase(positions.begin() + i * dim(), positions.begin() + (i + 1) * dim());
+            costs.erase(costs.begin() + i);
+        }
+        /** \fn resize(const size_t& npop)
+        *  \brief Changes the number of individuals, new individuals are set to zero
+        *  \param npop The new number of individuals
+        *  \return void
+        */
+        void resize(const size_t& npop)
+        {
+            positions.resize(npop * dim());
+            costs.resize(npop);
+        }
+        /** \fn reserve(const size_t& npop)
+        *  \brief Reserves storage so that the population can grow to npop individuals without reallocation
+        *  \param npop The number of individuals
+        *  \return void
+        */
+        void reserve(const size_t& npop)
+        {
+            positions.reserve(npop * dim());
+            costs.reserve(npop);
+        }
+        /** \fn clear()
+        *  \brief Removes all individuals, keeping the allocated storage
+        *  \return void
+        */
+        void clear()
+        {
+            positions.clear();
+            costs.clear();
+        }
+    private:
+        /** \brief Number of decision variables */
+        size_t ndv;
+        /** \brief Decision variables of all individuals, row-major */
+        std::vector<T> positions;
+        /** \brief Fitness column */
+        std::vector<T> costs;
+    };
+}
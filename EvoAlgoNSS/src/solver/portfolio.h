@@ -0,0 +1,121 @@
+/** \file portfolio.h
+* \author Ioannis Anagnostopoulos
+* \brief Algorithm portfolio: different solvers race on the same problem and the first to reach the tolerance wins
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <stop_token>
+#include "ealgorithm_base.h"
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /** \struct Portfolio_result
+    *  \brief The outcome of a portfolio solve
+    */
+    template<std::floating_point T>
+    struct Portfolio_result
+    {
+        /** \brief Result of the winning solver */
+        Result<T> result;
+        /** \brief Position of the winning solver in the arguments of solve_portfolio */
+        size_t winner;
+        /** \brief Type of the winning algorithm */
+        std::string_view algorithm;
+    };
+
+    /*! \fn race(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name, std::stop_token token, std::ostream& output)
+    *  \brief Solves the problem with one solver of a portfolio, stopping when a stop is requested on the token of the portfolio
+    *  \param f The objective function
+    *  \param c The constraints function
+    *  \param solver_struct The parameter structure of the solver
+    *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
+    *  \param token The stop token of the portfolio
+    *  \param output The stream the results are printed to when print_to_output is set
+    *  \return The solution vector, its fitness and the counters of the solve
+    */
+    template<size_t N, typename F, typename C, template<typename> class S, std::floating_point T>
+    Result<T> race(const F& f, const C& c, const S<T>& solver_struct, std::string_view problem_name, std::stop_token token, std::ostream& output)
+    {
+        Solver<S, T, F, C, N> solver{ solver_struct, f, c, solver_struct.seed };
+        solver.set_cancellation(std::move(token));
+        return solver.solver_bench(problem_name, output);
+    }
+
+    /*! \fn solve_portfolio(const F& f, const C& c, std::string_view problem_name, std::ostream& output, const S<T>&... solver_structs)
+    *  \brief Runs one solver per parameter structure on its own thread, the first solver to reach its tolerance stops the others
+    *  \details The other solvers stop cooperatively at their next iteration, with the best solution they have found so far. When no solver
+    *  reaches its tolerance, the winner is the solver with the best fitness. A stop requested on the cancellation token of any of the parameter
+    *  structures stops every solver, while the time budget of each structure applies to its own solver.
+    *  Every solver is seeded with the seed of its parameter structure.
+    *  Only the results of the winner are printed to the output, when its print_to_output is set, the results of every solver are printed to file
+    *  when print_to_file is set. The number of decision variables N can be given explicitly as for solve(), for example
+    *  solve_portfolio<6>(f, c, "YFT", std::cout, de, ga, pso).
+    *  \param f The objective function
+    *  \param c The constraints function
+    *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
+    *  \param output The stream the results of the winner are printed to when its print_to_output is set
+    *  \param solver_structs The parameter structures of the solvers, of any algorithm other than the root finder
+    *  \return The result of the winner, its position in the arguments and its type
+    */
+    template<size_t N = std::dynamic_extent, typename F, typename C, std::floating_point T, template<typename> class... S>
+    Portfolio_result<T> solve_portfolio(const F& f, const C& c, std::string_view problem_name, std::ostream& output, const S<T>&... solver_structs)
+    {
+        constexpr size_t nsolvers = sizeof...(S);
+        static_assert(nsolvers > 0);
+        const std::array<std::string_view, nsolvers> types{ solver_structs.type... };
+        std::array<Result<T>, nsolvers> results;
+        std::array<std::stringstream, nsolvers> outputs;
+        std::stop_source stop;
+        //! A stop requested on the token of any parameter structure stops the whole portfolio
+        const auto forward = [&stop]() { stop.request_stop(); };
+        const std::array<std::stop_callback<decltype(forward)>, nsolvers> callbacks{ std::stop_callback<decltype(forward)>(solver_structs.cancellation, forward)... };
+        std::atomic<size_t> winner{ nsolvers };
+        {
+            std::array<std::jthread, nsolvers> threads;
+            size_t k = 0;
+            ((threads[k] = std::jthread([&, k]()
+                {
+                    results[k] = race<N>(f, c, solver_structs, problem_name, stop.get_token(), outputs[k]);
+                    size_t none = nsolvers;
+                    if (results[k].solved && winner.compare_exchange_strong(none, k))
+                    {
+                        stop.request_stop();
+                    }
+                }), ++k), ...);
+        }
+        //! The threads have joined, without a solved solver the best fitness wins
+        size_t best = winner.load();
+        if (best == nsolvers)
+        {
+            best = 0;
+            for (size_t k = 1; k < nsolvers; ++k)
+            {
+                if (results[k].min_fitness < results[best].min_fitness)
+                {
+                    best = k;
+                }
+            }
+        }
+        output << outputs[best].str();
+        return { std::move(results[best]), best, types[best] };
+    }
+
+    /*! \fn solve_portfolio(const F& f, const C& c, std::string_view problem_name, const S<T>&... solver_structs)
+    *  \brief Algorithm portfolio wrapper function that prints the results of the winner to the terminal
+    *  \param f The objective function
+    *  \param c The constraints function
+    *  \param problem_name The name of the problem in std::string form. It is used to print results to file.
+    *  \param solver_structs The parameter structures of the solvers, of any algorithm other than the root finder
+    *  \return The result of the winner, its position in the arguments and its type
+    */
+    template<size_t N = std::dynamic_extent, typename F, typename C, std::floating_point T, template<typename> class... S>
+    Portfolio_result<T> solve_portfolio(const F& f, const C& c, std::string_view problem_name, const S<T>&... solver_structs)
+    {
+        return solve_portfolio<N>(f, c, problem_name, std::cout, solver_structs...);
+    }
+}
@@ -5,7 +5,7 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <boost/math/constants/constants.hpp>
 #include "ealgorithm_base.h"
 
 namespace ea
@@ -20,7 +20,9 @@ namespace ea
         /** \fn PSOs(const T& i_c1, const T& i_c2, const size_t& i_sneigh, const T& i_w, const T& i_alpha, const std::vector<T>& i_vmax, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
             const bool& i_use_penalty_method = false, const Constraints_type& i_constraints_type = Constraints_type::none,
-            const bool& i_print_to_output = true, const bool& i_print_to_file = true)
+            const bool& i_print_to_output = true, const bool& i_print_to_file = true, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {})
         \brief Constructor
         \param i_c1 c1 parameter for velocity update
         \param i_c2 c2 parameter for velocity update
@@ -37,13 +39,21 @@ namespace ea
         \param i_constraints_type What kind of constraints to use
         \param i_print_to_output Whether to print to terminal or not
         \param i_print_to_file Whether to print to a file or not
+        \param i_seed The seed of the random number engine of the solver
+        \param i_nthreads The number of threads used to evaluate the particles
+        \param i_trace_capacity The number of iterations kept by the convergence trace, 0 disables it
+        \param i_time_budget The wall-clock time in seconds the solve may take from the construction of the solver, 0 for no limit
+        \param i_cancellation A stop token, the solve stops at the first iteration after a stop is requested on it
+        \param i_stopping Additional stopping criteria, all disabled by default
         \return A PSO<T> object
         */
         PSOs(const T& i_c1, const T& i_c2, const size_t& i_sneigh, const T& i_w, const T& i_alpha, const std::vector<T>& i_vmax, const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
             const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
             const bool& i_use_penalty_method, const Constraints_type& i_constraints_type,
-            const bool& i_print_to_output, const bool& i_print_to_file) :
-            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file),
+            const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {}) :
+            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file, i_seed, i_nthreads, i_trace_capacity, i_time_budget, i_cancellation, i_stopping),
             c1(i_c1),
             c2(i_c2),
             sneigh(i_sneigh),
@@ -76,51 +86,43 @@ namespace ea
         std::string_view type = "Sub-swarm Particle Swarm Optimisation";
     };
 
-    /*! \class Solver<PSOs, T, F, C>
+    /*! \class Solver<PSOs, T, F, C, N>
     *  \brief Sub-Swarm Particle Swarm Optimisation (PSO) Class
     */
-    template<std::floating_point T, typename F, typename C>
-    class Solver<PSOs, T, F, C> : public Solver_base<Solver<PSOs, T, F, C>, PSOs, T, F, C>
+    template<std::floating_point T, typename F, typename C, size_t N>
+    class Solver<PSOs, T, F, C, N> : public Solver_base<Solver<PSOs, T, F, C, N>, PSOs, T, F, C, N>
     {
     public:
-        friend class Solver_base<Solver<PSOs, T, F, C>, PSOs, T, F, C>;
-        /*! \fn Solver(const PSOs<T>& i_pso, F f, C c)
+        friend class Solver_base<Solver<PSOs, T, F, C, N>, PSOs, T, F, C, N>;
+        /*! \fn Solver(const PSOs<T>& i_pso, F f, C c, const std::uint64_t& seed)
         *  \brief Constructor
         *  \param i_pso The particle swarm optimisation parameter structure that is used to construct the solver
         *  \param f A reference to the objective function
         *  \param c A reference to the constraints function
-        *  \return A Solver<PSOs, T, F, C> object
+        *  \param seed The seed of the random number engine
+        *  \return A Solver<PSOs, T, F, C, N> object
         */
-        Solver(const PSOs<T>& i_pso, F f, C c) :
-            Solver_base<Solver<PSOs, T, F, C>, PSOs, T, F, C>(i_pso, f, c),
+        Solver(const PSOs<T>& i_pso, F f, C c, const std::uint64_t& seed) :
+            Solver_base<Solver<PSOs, T, F, C, N>, PSOs, T, F, C, N>(i_pso, f, c, seed),
             pso(this->solver_struct),
             w(i_pso.w),
             vmax(i_pso.vmax),
+            personal_best(this->individuals),
             nneigh(static_cast<size_t>(std::ceil(i_pso.npop / i_pso.sneigh))),
-            neighbourhoods(set_neighbourhoods())
+            local_best(nneigh, i_pso.ndv),
+            velocity(i_pso.npop, i_pso.ndv),
+            neighbourhoods(set_neighbourhoods()),
+            r(3, i_pso.ndv)
         {
-            velocity.resize(pso.npop, std::vector<T>(pso.ndv));
-            local_best.resize(nneigh);
-            for (auto& p : velocity)
+            for (size_t k = 0; k < nneigh; ++k)
             {
-                for (auto& n : p)
-                {
-                    n = 0.0;
-                }
-            }
-            for (const auto& p : this->individuals)
-            {
-                personal_best.push_back(p);
-            }
-            for (auto& p : local_best)
-            {
-                p = personal_best[0];
+                local_best.set(k, personal_best[0], personal_best.fitness(0));
             }
             for (size_t i = 0; i < pso.npop; ++i)
             {
-                if (f(personal_best[i]) < f(local_best[neighbourhoods[i]]))
+                if (personal_best.fitness(i) < local_best.fitness(neighbourhoods[i]))
                 {
-                    local_best[neighbourhoods[i]] = personal_best[i];
+                    local_best.set(neighbourhoods[i], personal_best[i], personal_best.fitness(i));
                 }
             }
             find_min_local_best();
@@ -132,33 +134,55 @@ namespace ea
         T w;
         /** \brief Maximum Velocity is mutable, so a copy is created */
         std::vector<T> vmax;
-        /** \brief Personal best vector of the particles, holds the best position recorded for each particle */
-        std::vector<std::vector<T>> personal_best;
-        /** \brief Local best vector, holds the best position recorded for each neighbourhood */
-        std::vector<std::vector<T>> local_best;
-        /** \brief Velocity of the particles */
-        std::vector<std::vector<T>> velocity;
+        /** \brief Personal best of the particles, holds the best position and cost recorded for each particle */
+        Population<T, N> personal_best;
         /** \brief Number of neighbourhoods */
         const size_t nneigh;
+        /** \brief Local best, holds the best position and cost recorded for each neighbourhood */
+        Population<T, N> local_best;
+        /** \brief Velocity of the particles, the fitness column is not used */
+        Population<T, N> velocity;
         /** \brief Neighbourhoods */
-        std::unordered_map<size_t, size_t> neighbourhoods;
+        std::vector<size_t> neighbourhoods;
+        /** \brief Random coefficients r1, r2 and r3 of the velocity update rule, the fitness column is not used */
+        Population<T, N> r;
+        /** \brief Indices of the particles that moved to a feasible position and have not been evaluated yet */
+        std::vector<size_t> pending;
         /** \fn set_neighbourhoods
         *  \brief Set the neighbourhoods of the algorithm using particle indices
-        *  \return A map matching particle indices to neighbourhoods
+        *  \return A vector matching particle indices to neighbourhoods
         */
-        std::unordered_map<size_t, size_t> set_neighbourhoods();
+        std::vector<size_t> set_neighbourhoods();
         /*! \fn generate_r()
-        *  \brief This method generates r1 and r2 for the velocity update rule
-        *  \return A vector containing r1 and r2
+        *  \brief This method generates r1, r2 and r3 for the velocity update rule
+        *  \return void
         */
-        std::vector<std::vector<T>> generate_r();
+        void generate_r();
         /** \fn position_update()
         *  \brief Position update of the particles
         *  \return void
         */
         void position_update();
+        /** \fn accept_immigrant(const size_t& i)
+        *  \brief Updates the personal best of a particle replaced by a migrant and the local best of its neighbourhood
+        *  \param i The index of the particle
+        *  \return void
+        */
+        void accept_immigrant(const size_t& i)
+        {
+            if (this->individuals.fitness(i) < personal_best.fitness(i))
+            {
+                personal_best.set(i, this->individuals[i], this->individuals.fitness(i));
+            }
+            if (personal_best.fitness(i) < local_best.fitness(neighbourhoods[i]))
+            {
+                local_best.set(neighbourhoods[i], personal_best[i], personal_best.fitness(i));
+            }
+        }
         /** \fn best_update()
         *  \brief This method sets the personal and local best solutions
+        *  \details The feasible particles are evaluated as one batch (in parallel when the solver uses more than one thread)
+        *  before the bests are updated, which gives the same result as evaluating them one at a time
         *  \return void
         */
         void best_update();
@@ -168,7 +192,7 @@ namespace ea
         */
         void find_min_local_best();
         /** \fn check_pso_criteria
-        *  \brief Define the maximum radius stopping criterion
+        *  \brief The tolerance stopping criterion, the maximum radius of the swarm is one of the shared Stopping_criteria
         *  \return true if criteria are met, false otherwise
         */
         bool check_pso_criteria();
@@ -176,21 +200,13 @@ namespace ea
         *  \brief Runs the algorithm until stopping criteria
         *  return void
         */
-        void run_algo();
-        /** \fn euclid_distance
-        *  \brief Euclidean Distance of two vectors
-        *..\param x,y The two vectors for which the distance is calculated
-        *  \return Distance as a floating-point number
+        void run_algo() { this->run_iterations(0, pso.iter_max); }
+        /** \fn iterate(const size_t& iter)
+        *  \brief Runs one iteration of the algorithm
+        *  \param iter The iteration
+        *  \return True if the stopping criteria are met
         */
-        T euclid_distance(const std::vector<T>& x, const std::vector<T>& y)
-        {
-            T sum = 0;
-            for (size_t i = 0; i < x.size(); ++i)
-            {
-                sum = sum + std::pow(x[i] - y[i], 2);
-            }
-            return std::sqrt(sum);
-        }
+        bool iterate(const size_t& iter);
         /*! \fn display_parameters()
         *  \brief Display PSO parameters
         *  \return A std::stringstream of the parameters
@@ -208,10 +224,10 @@ namespace ea
         }
     };
 
-    template<std::floating_point T, typename F, typename C>
-    std::unordered_map<size_t, size_t> Solver<PSOs, T, F, C>::set_neighbourhoods()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    std::vector<size_t> Solver<PSOs, T, F, C, N>::set_neighbourhoods()
     {
-        std::unordered_map<size_t, size_t> neighbourhoods;
+        std::vector<size_t> neighbourhoods(pso.npop, 0);
         size_t neigh_index = 0;
         size_t counter = 0;
         for (size_t i = 0; i < pso.npop; ++i)
@@ -230,124 +246,115 @@ namespace ea
         return neighbourhoods;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    std::vector<std::vector<T>> Solver<PSOs, T, F, C>::generate_r()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOs, T, F, C, N>::generate_r()
     {
-        std::vector<std::vector<T>> r(3, std::vector<T>(pso.ndv));
-        for (auto i = 0; i < 3; ++i)
+        for (size_t i = 0; i < r.size(); ++i)
         {
-            for (size_t j = 0; j < pso.ndv; ++j)
+            for (auto& p : r[i])
             {
-                r[i][j] = (this->distribution(generator));
+                p = this->distribution(this->generator);
             }
         }
-        return r;
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOs, T, F, C>::position_update()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOs, T, F, C, N>::position_update()
     {
         for (size_t i = 0; i < pso.npop; ++i)
         {
-            for (size_t j = 0; j < pso.ndv; ++j)
+            //! The random coefficients are drawn once per particle
+            generate_r();
+            const auto x = this->individuals[i];
+            const auto v = velocity[i];
+            const auto l = local_best[neighbourhoods[i]];
+            const auto r2 = r[1];
+            for (size_t j = 0; j < this->dim(); ++j)
             {
-                const auto& r = generate_r();
-                velocity[i][j] = 0.729 * velocity[i][j] + //pso.c1 * r[0][j] * (personal_best[i][j] - this->individuals[i][j])
-                    +pso.c2 * r[1][j] * (local_best[neighbourhoods[i]][j] - this->individuals[i][j]) //+(w / 2) * r[2][j]*(min_cost[j] - this->individuals[i][j]);
+                v[j] = 0.729 * v[j] + //pso.c1 * r[0][j] * (personal_best[i][j] - x[j])
+                    +pso.c2 * r2[j] * (l[j] - x[j]) //+(w / 2) * r[2][j]*(min_cost[j] - x[j]);
                     ;
-                if (velocity[i][j] > vmax[j])
+                if (v[j] > vmax[j])
                 {
-                    velocity[i][j] = vmax[j];
+                    v[j] = vmax[j];
                 }
-                this->individuals[i][j] = this->individuals[i][j] + velocity[i][j];
+                x[j] = x[j] + v[j];
             }
         }
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOs, T, F, C>::best_update()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOs, T, F, C, N>::best_update()
     {
+        pending.clear();
         for (size_t i = 0; i < pso.npop; ++i)
         {
             //! Checks that the candidate is feasible
-            if (!this->c(this->individuals[i]))
+            if (!this->check_constraints(this->individuals[i]))
             {
-                this->individuals[i] = personal_best[i];
+                this->individuals.set(i, personal_best[i], personal_best.fitness(i));
             }
-            if (this->f(this->individuals[i]) < this->f(personal_best[i]))
+            else
             {
-                personal_best[i] = this->individuals[i];
+                pending.push_back(i);
             }
-            if (this->f(personal_best[i]) < this->f(local_best[neighbourhoods[i]]))
+        }
+        this->evaluate_population(this->individuals, pending);
+        Phase_timer phase{ this->counters.selection_time };
+        for (size_t i = 0; i < pso.npop; ++i)
+        {
+            if (this->individuals.fitness(i) < personal_best.fitness(i))
             {
-                local_best[neighbourhoods[i]] = personal_best[i];
+                personal_best.set(i, this->individuals[i], this->individuals.fitness(i));
+            }
+            if (personal_best.fitness(i) < local_best.fitness(neighbourhoods[i]))
+            {
+                local_best.set(neighbourhoods[i], personal_best[i], personal_best.fitness(i));
             }
         }
     }
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOs, T, F, C>::find_min_local_best()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<PSOs, T, F, C, N>::find_min_local_best()
     {
+        Phase_timer phase{ this->counters.selection_time };
         for (size_t k = 0; k < nneigh; ++k)
         {
-            if (this->f(local_best[k]) < this->f(this->min_cost))
+            if (local_best.fitness(k) < this->min_fitness)
             {
-                this->min_cost = local_best[k];
+                this->min_cost.assign(local_best[k].begin(), local_best[k].end());
+                this->min_fitness = local_best.fitness(k);
             }
         }
     }
 
-    template<std::floating_point T, typename F, typename C>
-    bool Solver<PSOs, T, F, C>::check_pso_criteria()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<PSOs, T, F, C, N>::check_pso_criteria()
     {
-        std::vector<T> distance(pso.npop);
-        for (size_t i = 0; i < pso.npop; ++i)
-        {
-            distance[i] = euclid_distance(this->individuals[i], this->min_cost);
-        }
-        T rmax = distance[0];
-        for (size_t i = 0; i < pso.npop; ++i)
-        {
-            if (rmax < distance[i])
-            {
-                rmax = distance[i];
-            }
-            else
-            {
-            }
-        }
-        if (pso.tol > std::abs(this->f(this->min_cost))) //|| rmax < pso.tol)
-        {
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+        return pso.tol > std::abs(this->min_fitness);
     }
 
     /** \brief Inverse square of pi constant */
     template<std::floating_point T>
     const double inv_pi_sq_2 = 1 / std::pow(boost::math::constants::pi<T>(), 2);
 
-    template<std::floating_point T, typename F, typename C>
-    void Solver<PSOs, T, F, C>::run_algo()
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<PSOs, T, F, C, N>::iterate(const size_t& iter)
     {
         //! Local Best Particle Swarm starts here
-        for (size_t iter = 0; iter < pso.iter_max; ++iter)
+        position_update();
+        best_update();
+        find_min_local_best();
+        //! Inertia is updated
+        w = pso.w - (pso.w - 0.4) * std::pow((static_cast<T>(iter) / static_cast<T>(pso.iter_max)), inv_pi_sq_2<T>);
+        this->last_iter = iter;
+        this->record_iteration(iter);
+        if (check_pso_criteria())
         {
-            position_update();
-            best_update();
-            find_min_local_best();
-            //! Inertia is updated
-            w = pso.w - (pso.w - 0.4) * std::pow((static_cast<T>(iter) / static_cast<T>(pso.iter_max)), inv_pi_sq_2<T>);
-            this->last_iter = iter;
-            if (check_pso_criteria())
-            {
-                this->solved_flag = true;
-                break;
-            }
+            this->solved_flag = true;
+            return true;
         }
+        return false;
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,246 @@
+/** \file results_sink.h
+* \author Ioannis Anagnostopoulos
+* \brief A process-wide sink that writes the results of the solvers to files on a background thread
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /*! \class Results_sink
+    *  \brief Collects records of results in memory and appends them to their files on a background thread
+    *  \details A solve only moves its formatted record into a queue, so that opening and writing files is not on its critical path.
+    *  The writer thread takes all queued records at once and flushes the files after every batch. It never has more than max_open_files
+    *  files open: before a file is opened, the least recently used one is flushed and closed, so that a process writing to many files,
+    *  such as one per bond, does not run out of file descriptors. The records of a file are written in the order they were submitted. Every record has been written, or reported
+    *  as dropped on std::cerr when its file could not be opened or written, when flush() returns and when the process exits normally.
+    */
+    class Results_sink
+    {
+    public:
+        /** \fn instance()
+        *  \brief The sink of the process, created on first use
+        *  \return A reference to the sink
+        */
+        static Results_sink& instance()
+        {
+            static Results_sink sink;
+            return sink;
+        }
+        Results_sink(const Results_sink&) = delete;
+        Results_sink& operator=(const Results_sink&) = delete;
+        /** \fn submit(std::string filename, std::string record)
+        *  \brief Queues a record to be appended to a file
+        *  \param filename The name of the file
+        *  \param record The text that is appended to the file
+        *  \return void
+        */
+        void submit(std::string filename, std::string record)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.push_back({ std::move(filename), std::move(record) });
+                ++submitted;
+            }
+            queued.notify_one();
+        }
+        /** \fn flush()
+        *  \brief Waits until every record submitted before the call has been written and flushed to its file
+        *  \return False if a record has been dropped since the sink was created, because its file could not be opened or written
+        */
+        bool flush()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const size_t target = submitted;
+            done.wait(lock, [&]() { return written >= target; });
+            return dropped == 0;
+        }
+    private:
+        /** \struct Record
+        *  \brief A record and the file it is appended to
+        */
+        struct Record
+        {
+            /** \brief Name of the file */
+            std::string filename;
+            /** \brief Text of the record */
+            std::string text;
+        };
+        /** \struct Open_file
+        *  \brief An open file of the writer thread
+        */
+        struct Open_file
+        {
+            /** \brief Handle of the file */
+            std::ofstream stream;
+            /** \brief Number of the record last written to the file */
+            size_t last_used;
+            /** \brief Records written since the last flush */
+            size_t unflushed;
+        };
+        /** \brief Maximum number of files open at any time */
+        static constexpr size_t max_open_files = 64;
+        /** \brief Protects the queue and the counters */
+        std::mutex mutex;
+        /** \brief Wakes the writer when records are queued or the sink stops */
+        std::condition_variable queued;
+        /** \brief Wakes the callers of flush() when a batch has been written */
+        std::condition_variable done;
+        /** \brief Records that have not been taken by the writer */
+        std::vector<Record> pending;
+        /** \brief Number of records submitted */
+        size_t submitted;
+        /** \brief Number of records written or dropped */
+        size_t written;
+        /** \brief Number of records dropped */
+        size_t dropped;
+        /** \brief Set when the sink is destroyed */
+        bool stop;
+        /** \brief Open files by name, only used by the writer thread */
+        std::unordered_map<std::string, Open_file> files;
+        /** \brief Number of records taken by the writer thread, only used by the writer thread */
+        size_t records;
+        /** \brief Writer thread, declared last so that it starts after the other members are initialised */
+        std::thread writer;
+        /** \fn Results_sink()
+        *  \brief Constructor, starts the writer thread
+        */
+        Results_sink() :
+            submitted{ 0 },
+            written{ 0 },
+            dropped{ 0 },
+            stop{ false },
+            records{ 0 },
+            writer{ [this]() { work(); } }
+        {
+        }
+        /** \fn ~Results_sink()
+        *  \brief Destructor, writes the remaining records and joins the writer thread
+        */
+        ~Results_sink()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            queued.notify_one();
+            writer.join();
+        }
+        /** \fn work()
+        *  \brief Loop of the writer thread
+        *  \return void
+        */
+        void work()
+        {
+            std::vector<Record> batch;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    queued.wait(lock, [this]() { return stop || !pending.empty(); });
+                    if (pending.empty())
+                    {
+                        return;
+                    }
+                    batch.swap(pending);
+                }
+                size_t failed = 0;
+                for (const auto& p : batch)
+                {
+                    ++records;
+                    auto it = files.find(p.filename);
+                    if (it == files.end())
+                    {
+                        if (files.size() >= max_open_files)
+                        {
+                            failed += close_least_recently_used();
+                        }
+                        std::ofstream stream(p.filename, std::ofstream::out | std::ofstream::app);
+                        if (!stream.is_open())
+                        {
+                            std::cerr << "Results_sink: could not open " << p.filename << ", a record was dropped\n";
+                            ++failed;
+                            continue;
+                        }
+                        it = files.emplace(p.filename, Open_file{ std::move(stream), records, 0 }).first;
+                    }
+                    it->second.stream << p.text;
+                    it->second.last_used = records;
+                    ++it->second.unflushed;
+                }
+                failed += flush_files();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    written += batch.size();
+                    dropped += failed;
+                }
+                done.notify_all();
+                batch.clear();
+            }
+        }
+        /** \fn flush_files()
+        *  \brief Flushes the files written since their last flush, a file that cannot be written is reported and closed
+        *  \return The number of records lost in the files that could not be written
+        */
+        size_t flush_files()
+        {
+            size_t failed = 0;
+            for (auto it = files.begin(); it != files.end();)
+            {
+                if (it->second.unflushed == 0 || flush_file(it->first, it->second))
+                {
+                    ++it;
+                    continue;
+                }
+                failed += it->second.unflushed;
+                it = files.erase(it);
+            }
+            return failed;
+        }
+        /** \fn close_least_recently_used()
+        *  \brief Flushes and closes the least recently used file, called before a file is opened when max_open_files are open
+        *  \return The number of records lost if the file could not be written
+        */
+        size_t close_least_recently_used()
+        {
+            auto oldest = files.begin();
+            for (auto it = files.begin(); it != files.end(); ++it)
+            {
+                if (it->second.last_used < oldest->second.last_used)
+                {
+                    oldest = it;
+                }
+            }
+            const size_t failed = flush_file(oldest->first, oldest->second) ? 0 : oldest->second.unflushed;
+            files.erase(oldest);
+            return failed;
+        }
+        /** \fn flush_file(const std::string& name, Open_file& file)
+        *  \brief Flushes a file and reports on std::cerr the records lost when it cannot be written
+        *  \param name The name of the file
+        *  \param file The open file
+        *  \return True if the file was written
+        */
+        bool flush_file(const std::string& name, Open_file& file)
+        {
+            file.stream.flush();
+            if (!file.stream)
+            {
+                std::cerr << "Results_sink: could not write " << name << ", " << file.unflushed << " records were dropped\n";
+                return false;
+            }
+            file.unflushed = 0;
+            return true;
+        }
+    };
+}
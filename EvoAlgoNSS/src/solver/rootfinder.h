@@ -0,0 +1,250 @@
+/** \file rootfinder.h
+* \author Ioannis Anagnostopoulos
+* \brief Classes and functions for a deterministic one-dimensional root finder, used for the internal rate of return
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include "ealgorithm_base.h"
+
+namespace ea
+{
+    /** \concept residual_objective
+    *  \brief An objective function that also returns the residual of an equation in one unknown and its derivative
+    *  \details The root of the residual is a minimum of the objective function, for example the internal rate of return, where the present value
+    *  minus the price is zero and the squared pricing error is minimal. Combine it with the usual signature through utilities::overloaded.
+    */
+    template<typename F, typename T>
+    concept residual_objective =
+        requires(const F& f, const T& x) {
+            { f(x) } -> std::convertible_to<std::pair<T, T>>;
+    };
+
+    /** \struct Root
+    *  \brief Safeguarded Newton Structure, used in the actual algorithm and for type deduction
+    *  \details The solver needs an objective function that satisfies residual_objective and a single decision variable. The population
+    *  of the base class has one individual, the starting value, which is neither randomised nor evaluated and is replaced by the root.
+    *  Newton always iterates from the starting value, since the tolerance applies to the step and not to the fitness. Every iterate is checked with
+    *  the constraints function, the penalty method only enters the fitness of the root through the objective function. The iterations are not
+    *  recorded in a convergence trace and the additional stopping criteria do not apply.
+    */
+    template<std::floating_point T>
+    struct Root : EA_base<T>
+    {
+    public:
+        /** \fn Root(const std::vector<T>& i_decision_variables, const T& i_lower, const T& i_upper, const T& i_tol, const size_t& i_iter_max,
+            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type, const bool& i_print_to_output, const bool& i_print_to_file,
+            const std::uint64_t& i_seed = default_seed, const size_t& i_nthreads = 1, const double& i_time_budget = 0, std::stop_token i_cancellation = {})
+        *	\brief Constructor
+        *	\param i_decision_variables The starting value of the decision variable, the first Newton iterate
+        *	\param i_lower The lower end of the bracket of the root
+        *	\param i_upper The upper end of the bracket of the root
+        *	\param i_tol The tolerance on the root, the iterations stop when a step is shorter than it
+        *	\param i_iter_max The maximum number of iterations
+        *	\param i_use_penalty_method Whether to used penalties or not
+        *	\param i_constraints_type What kind of constraints to use
+        *	\param i_print_to_output Whether to print to terminal or not
+        *	\param i_print_to_file Whether to print to a file or not
+        *	\param i_seed The seed of the random number engine of the solver, only used for the individual of the base class
+        *	\param i_nthreads The number of threads, the iterations are sequential so only one is used
+        *	\param i_time_budget The wall-clock time in seconds the solve may take from the construction of the solver, 0 for no limit
+        *	\param i_cancellation A stop token, the solve stops at the first iteration after a stop is requested on it
+        *	\return A Root<T> object
+        */
+        Root(const std::vector<T>& i_decision_variables, const T& i_lower, const T& i_upper, const T& i_tol, const size_t& i_iter_max,
+            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type,
+            const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const double& i_time_budget = 0, std::stop_token i_cancellation = {}) :
+            EA_base<T>(i_decision_variables, std::vector<T>(i_decision_variables.size(), (i_upper - i_lower) / 2), 1, i_tol, i_iter_max,
+                i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file, i_seed, i_nthreads, 0, i_time_budget, i_cancellation, Stopping_criteria<T>{}),
+            lower(i_lower),
+            upper(i_upper)
+        {
+            assert(this->ndv == 1);
+            assert(lower < upper);
+        }
+        /** \brief Lower end of the bracket */
+        const T lower;
+        /** \brief Upper end of the bracket */
+        const T upper;
+        /** \brief Type of the algorithm */
+        std::string_view type = "Safeguarded Newton";
+        /** \brief The root finder iterates from the starting value, without a random initial population */
+        static constexpr bool random_initial_population = false;
+    };
+
+    /*! \class Solver<Root, T, F, C, N>
+    *  \brief Safeguarded Newton Class
+    *  \details Newton steps use the analytic derivative of the residual. While the root is bracketed, a step that leaves the bracket or does not
+    *  halve the residual fast enough is replaced by a bisection step, so the iterations converge quadratically close to the root and never diverge.
+    *  When the residual has the same sign at both ends of the bracket, plain Newton steps are taken from the starting value.
+    *  An iterate that does not satisfy the constraints is replaced by a bisection step while the root is bracketed, otherwise the step is halved
+    *  until the iterate satisfies them and does not count towards the tolerance. The iterations stop without a solution when no such iterate is found.
+    */
+    template<std::floating_point T, typename F, typename C, size_t N>
+    class Solver<Root, T, F, C, N> : public Solver_base<Solver<Root, T, F, C, N>, Root, T, F, C, N>
+    {
+        static_assert(residual_objective<F, T>, "The objective function of the Root solver must also return the residual and its derivative");
+        static_assert(N == 1 || N == std::dynamic_extent, "The Root solver has a single decision variable");
+    public:
+        friend class Solver_base<Solver<Root, T, F, C, N>, Root, T, F, C, N>;
+        /*! \fn Solver(const Root<T>& i_root, const F& f, const C& c, const std::uint64_t& seed)
+        *  \brief Constructor
+        *  \param i_root The root finder parameter structure that is used to construct the solver
+        *  \param f A reference to the objective function
+        *  \param c A reference to the constraints function
+        *  \param seed The seed of the random number engine
+        *  \return A Solver<Root, T, F, C, N> object
+        */
+        Solver(const Root<T>& i_root, const F& f, const C& c, const std::uint64_t& seed) :
+            Solver_base<Solver<Root, T, F, C, N>, Root, T, F, C, N>(i_root, f, c, seed),
+            root(this->solver_struct)
+        {
+        };
+    private:
+        /** \brief Root finder structure used internally (reference to solver_struct) */
+        const Root<T>& root;
+        /** \fn residual(const T& x)
+        *  \brief Evaluates the residual and its derivative, counts the evaluation and adds its time to the evaluation time
+        *  \param x The point
+        *  \return The residual at x and its derivative
+        */
+        std::pair<T, T> residual(const T& x)
+        {
+            ++this->counters.evaluations;
+            Phase_timer phase{ this->counters.evaluation_time };
+            return this->f(x);
+        }
+        /** \fn feasible(const T& x)
+        *  \brief Checks a point with the constraints function and counts the check
+        *  \param x The point
+        *  \return True if the constraints are satisfied
+        */
+        bool feasible(const T& x)
+        {
+            const std::array<T, 1> point{ x };
+            return this->check_constraints(point);
+        }
+        /*! \fn display_parameters()
+        *  \brief  Display the parameters of the root finder
+        *  \return A std::stringstream of the parameters
+        */
+        std::stringstream display_parameters()
+        {
+            std::stringstream parameters;
+            parameters << "Lower Bound:" << "," << root.lower << ",";
+            parameters << "Upper Bound:" << "," << root.upper;
+            return parameters;
+        }
+        /** \fn run_algo
+        *  \brief Runs the algorithm until stopping criteria
+        *  return void
+        */
+        void run_algo();
+    };
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<Root, T, F, C, N>::run_algo()
+    {
+        const T g_lower = residual(root.lower).first;
+        const T g_upper = residual(root.upper).first;
+        const bool bracketed = (g_lower <= 0 && g_upper >= 0) || (g_lower >= 0 && g_upper <= 0);
+        //! x_negative and x_positive are the ends of the bracket where the residual is negative and positive
+        T x_negative = g_lower < 0 ? root.lower : root.upper;
+        T x_positive = g_lower < 0 ? root.upper : root.lower;
+        T x = root.decision_variables[0];
+        if (bracketed && (x <= root.lower || x >= root.upper || !feasible(x)))
+        {
+            x = (root.lower + root.upper) / 2;
+        }
+        auto [g, dg] = residual(x);
+        T step = root.upper - root.lower;
+        T previous_step = step;
+        for (size_t iter = 0; iter < root.iter_max; ++iter)
+        {
+            this->last_iter = iter;
+            if (this->interrupted())
+            {
+                break;
+            }
+            if (g == 0)
+            {
+                this->solved_flag = true;
+                this->reason = Stop_reason::tolerance;
+                break;
+            }
+            //! A step shortened by the constraints does not show convergence
+            bool shortened = false;
+            if (bracketed)
+            {
+                //! Bisect when the Newton step leaves the bracket, when it would not shrink faster than bisection or when its iterate is not feasible
+                const bool outside = ((x - x_positive) * dg - g) * ((x - x_negative) * dg - g) > 0;
+                if (outside || std::abs(2 * g) > std::abs(previous_step * dg) || !feasible(x - g / dg))
+                {
+                    previous_step = step;
+                    step = (x_positive - x_negative) / 2;
+                    if (!feasible(x_negative + step))
+                    {
+                        break;
+                    }
+                    x = x_negative + step;
+                }
+                else
+                {
+                    previous_step = step;
+                    step = g / dg;
+                    x = x - step;
+                }
+            }
+            else
+            {
+                if (dg == 0 || !std::isfinite(dg))
+                {
+                    break;
+                }
+                step = g / dg;
+                if (!std::isfinite(x - step))
+                {
+                    break;
+                }
+                //! The step is halved until the iterate satisfies the constraints, the iterations stop when it no longer moves the iterate
+                bool accepted = feasible(x - step);
+                while (!accepted && x - step / 2 != x)
+                {
+                    step = step / 2;
+                    shortened = true;
+                    accepted = feasible(x - step);
+                }
+                if (!accepted)
+                {
+                    break;
+                }
+                x = x - step;
+            }
+            std::tie(g, dg) = residual(x);
+            if (std::abs(step) < root.tol && !shortened)
+            {
+                this->solved_flag = true;
+                this->reason = Stop_reason::tolerance;
+                break;
+            }
+            if (g < 0)
+            {
+                x_negative = x;
+            }
+            else
+            {
+                x_positive = x;
+            }
+        }
+        //! The root replaces the individual of the population, its fitness is the value of the objective function
+        const std::array<T, 1> solution{ x };
+        this->individuals.set(0, solution, this->evaluate(solution));
+        this->min_cost.assign(solution.begin(), solution.end());
+        this->min_fitness = this->individuals.fitness(0);
+    }
+}
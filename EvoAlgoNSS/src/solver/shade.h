@@ -0,0 +1,413 @@
+/** \file shade.h
+* \author Ioannis Anagnostopoulos
+* \brief Classes and functions for Success-History based Adaptive Differential Evolution with Linear Population Size Reduction (L-SHADE)
+*/
+
+#pragma once
+
+#include <cmath>
+#include "ealgorithm_base.h"
+
+namespace ea
+{
+    /** \struct SHADE
+    *  \brief Success-History based Adaptive Differential Evolution Structure, used in the actual algorithm and for type deduction
+    *  \details Unlike DE, the crossover rate and the mutation scale factor are not parameters: every trial vector draws its own around
+    *  the values that produced successful trial vectors in the previous generations, which are kept in a memory of memory_size entries.
+    *  The trial vectors are built with the current-to-pbest/1 mutation, the second difference vector may use the parents replaced in
+    *  previous generations, which are kept in an archive. The population shrinks linearly from npop to min_npop over the evaluation budget,
+    *  which is the maximum number of evaluations of the stopping criteria when it is set and npop * iter_max otherwise.
+    */
+    template<std::floating_point T>
+    struct SHADE : EA_base<T>
+    {
+    public:
+        /** \fn SHADE(const size_t& i_memory_size, const T& i_p_best, const T& i_archive_rate, const size_t& i_min_npop,
+            const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
+            const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
+            const bool& i_use_penalty_method = false, const Constraints_type& i_constraints_type = Constraints_type::none,
+            const bool& i_print_to_output = true, const bool& i_print_to_file = true, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {})
+        *	\brief Constructor
+        *	\param i_memory_size The number of entries of the memories of the crossover rate and the mutation scale factor
+        *	\param i_p_best The fraction of the best individuals of the population the pbest individual of a mutation is drawn from
+        *	\param i_archive_rate The size of the archive relative to the size of the population, 0 disables the archive
+        *	\param i_min_npop The size of the population at the end of the evaluation budget, at least 4
+        *	\param i_decision_variables The starting values of the decision variables
+        *	\param i_stdev The standard deviation
+        *	\param i_npop The initial population size
+        *	\param i_tol The tolerance
+        *	\param i_iter_max The maximum number of iterations
+        *	\param i_use_penalty_method Whether to used penalties or not
+        *	\param i_constraints_type What kind of constraints to use
+        *	\param i_print_to_output Whether to print to terminal or not
+        *	\param i_print_to_file Whether to print to a file or not
+        *	\param i_seed The seed of the random number engine of the solver
+        *	\param i_nthreads The number of threads used to evaluate the trial vectors of a generation
+        *	\param i_trace_capacity The number of iterations kept by the convergence trace, 0 disables it
+        *	\param i_time_budget The wall-clock time in seconds the solve may take from the construction of the solver, 0 for no limit
+        *	\param i_cancellation A stop token, the solve stops at the first iteration after a stop is requested on it
+        *	\param i_stopping Additional stopping criteria, all disabled by default. Their maximum number of evaluations is also the evaluation budget of the population reduction
+        *	\return A SHADE<T> object
+        */
+        SHADE(const size_t& i_memory_size, const T& i_p_best, const T& i_archive_rate, const size_t& i_min_npop,
+            const std::vector<T>& i_decision_variables, const std::vector<T>& i_stdev,
+            const size_t& i_npop, const T& i_tol, const size_t& i_iter_max,
+            const bool& i_use_penalty_method, const Constraints_type& i_constraints_type,
+            const bool& i_print_to_output, const bool& i_print_to_file, const std::uint64_t& i_seed = default_seed,
+            const size_t& i_nthreads = 1, const size_t& i_trace_capacity = 0,
+            const double& i_time_budget = 0, std::stop_token i_cancellation = {}, const Stopping_criteria<T>& i_stopping = {}) :
+            EA_base<T>(i_decision_variables, i_stdev, i_npop, i_tol, i_iter_max, i_use_penalty_method, i_constraints_type, i_print_to_output, i_print_to_file, i_seed, i_nthreads, i_trace_capacity, i_time_budget, i_cancellation, i_stopping),
+            memory_size(i_memory_size),
+            p_best(i_p_best),
+            archive_rate(i_archive_rate),
+            min_npop(i_min_npop)
+        {
+            assert(memory_size > 0);
+            assert(p_best > 0 && p_best <= 1);
+            assert(archive_rate >= 0);
+            assert(min_npop >= 4 && min_npop <= this->npop);
+        }
+        /** \brief Number of entries of the memories of the crossover rate and the mutation scale factor */
+        const size_t memory_size;
+        /** \brief Fraction of the best individuals the pbest individual is drawn from */
+        const T p_best;
+        /** \brief Size of the archive relative to the size of the population */
+        const T archive_rate;
+        /** \brief Size of the population at the end of the evaluation budget */
+        const size_t min_npop;
+        /** \brief Type of the algorithm */
+        std::string_view type = "Success-History Adaptive Differential Evolution";
+    };
+
+    /*! \class Solver<SHADE, T, F, C, N>
+    *  \brief Success-History based Adaptive Differential Evolution Algorithm with Linear Population Size Reduction (L-SHADE) Class
+    *  \details The generations are synchronous: all trial vectors are constructed from the current population and evaluated as one batch,
+    *  in parallel when the solver uses more than one thread.
+    */
+    template<std::floating_point T, typename F, typename C, size_t N>
+    class Solver<SHADE, T, F, C, N> : public Solver_base<Solver<SHADE, T, F, C, N>, SHADE, T, F, C, N>
+    {
+    public:
+        friend class Solver_base<Solver<SHADE, T, F, C, N>, SHADE, T, F, C, N>;
+        /*! \fn Solver(const SHADE<T>& i_shade, const F& f, const C& c, const std::uint64_t& seed)
+        *  \brief Constructor
+        *  \param i_shade The adaptive differential evolution parameter structure that is used to construct the solver
+        *  \param f A reference to the objective function
+        *  \param c A reference to the constraints function
+        *  \param seed The seed of the random number engine
+        *  \return A Solver<SHADE, T, F, C, N> object
+        */
+        Solver(const SHADE<T>& i_shade, const F& f, const C& c, const std::uint64_t& seed) :
+            Solver_base<Solver<SHADE, T, F, C, N>, SHADE, T, F, C, N>(i_shade, f, c, seed),
+            shade(this->solver_struct),
+            memory_cr(shade.memory_size, 0.5),
+            memory_f(shade.memory_size, 0.5),
+            memory_position(0),
+            trials(0, shade.ndv),
+            archive(0, shade.ndv),
+            survivors(0, shade.ndv)
+        {
+            //! The population only shrinks, so the buffers are allocated once for the initial population
+            trials.reserve(shade.npop);
+            archive.reserve(archive_capacity(shade.npop));
+            survivors.reserve(shade.npop);
+            cr.reserve(shade.npop);
+            f_param.reserve(shade.npop);
+            order.reserve(shade.npop);
+            success_cr.reserve(shade.npop);
+            success_f.reserve(shade.npop);
+            improvements.reserve(shade.npop);
+        };
+    private:
+        /** \brief Adaptive Differential Evolution structure used internally (reference to solver_struct) */
+        const SHADE<T>& shade;
+        /** \brief Memory of the crossover rates of the successful trial vectors */
+        std::vector<T> memory_cr;
+        /** \brief Memory of the mutation scale factors of the successful trial vectors */
+        std::vector<T> memory_f;
+        /** \brief Entry of the memories updated at the end of the next generation with successful trial vectors */
+        size_t memory_position;
+        /** \brief Trial vectors of a generation, one per individual */
+        Population<T, N> trials;
+        /** \brief Parents replaced by better trial vectors, used by the second difference vector of the mutation */
+        Population<T, N> archive;
+        /** \brief The individuals kept by the population reduction, reused across generations */
+        Population<T, N> survivors;
+        /** \brief Crossover rate of every trial vector of a generation */
+        std::vector<T> cr;
+        /** \brief Mutation scale factor of every trial vector of a generation */
+        std::vector<T> f_param;
+        /** \brief Indices of the individuals, partially ordered by fitness, reused across generations */
+        std::vector<size_t> order;
+        /** \brief Crossover rates of the successful trial vectors of a generation */
+        std::vector<T> success_cr;
+        /** \brief Mutation scale factors of the successful trial vectors of a generation */
+        std::vector<T> success_f;
+        /** \brief Fitness improvements of the successful trial vectors of a generation, the weights of the memory update */
+        std::vector<T> improvements;
+        /** \fn archive_capacity(const size_t& npop) const
+        *  \param npop The size of the population
+        *  \return The size of the archive for the population
+        */
+        size_t archive_capacity(const size_t& npop) const
+        {
+            return static_cast<size_t>(std::round(shade.archive_rate * static_cast<T>(npop)));
+        }
+        /** \fn evaluation_budget() const
+        *  \return The number of evaluations over which the population shrinks to min_npop
+        */
+        size_t evaluation_budget() const
+        {
+            return shade.stopping.max_evaluations > 0 ? shade.stopping.max_evaluations : shade.npop * shade.iter_max;
+        }
+        /** \fn sample_parameters(const size_t& i)
+        *  \brief Draws the crossover rate of a trial vector from a normal distribution and its mutation scale factor from a Cauchy distribution,
+        *  both centred on a random entry of the memories
+        *  \param i The index of the trial vector
+        *  \return void
+        */
+        void sample_parameters(const size_t& i);
+        /** \fn construct_trial(const size_t& i, const size_t& npbest, std::span<T, N> trial)
+        *  \brief Constructs a trial vector with the current-to-pbest/1 mutation and the binomial crossover
+        *  \param i The index of the target vector
+        *  \param npbest The number of the best individuals the pbest individual is drawn from, which are the first npbest of order
+        *  \param trial The trial vector, overwritten by this method
+        *  \return void
+        */
+        void construct_trial(const size_t& i, const size_t& npbest, std::span<T, N> trial);
+        /** \fn archive_parent(const size_t& i)
+        *  \brief Adds a parent replaced by a better trial vector to the archive, a random member is replaced when the archive is full
+        *  \param i The index of the parent
+        *  \return void
+        */
+        void archive_parent(const size_t& i);
+        /** \fn update_memory()
+        *  \brief Writes the means of the parameters of the successful trial vectors, weighted by their improvements, to the memories
+        *  \details The crossover rate is the weighted arithmetic mean and the mutation scale factor the weighted Lehmer mean
+        *  \return void
+        */
+        void update_memory();
+        /** \fn reduce_population()
+        *  \brief Removes the worst individuals so that the size of the population decreases linearly with the evaluations, and shrinks the archive with it
+        *  \return void
+        */
+        void reduce_population();
+        /*! \fn display_parameters()
+        *  \brief  Display the parameters of SHADE
+        *  \return A std::stringstream of the parameters
+        */
+        std::stringstream display_parameters()
+        {
+            std::stringstream parameters;
+            parameters << "Memory Size:" << "," << shade.memory_size << ",";
+            parameters << "p-best Rate:" << "," << shade.p_best << ",";
+            parameters << "Archive Rate:" << "," << shade.archive_rate << ",";
+            parameters << "Minimum Population:" << "," << shade.min_npop << ",";
+            parameters << "Crossover Rate Memory:" << "," << memory_cr << ",";
+            parameters << "Mutation Scale Factor Memory:" << "," << memory_f;
+            return parameters;
+        }
+        /** \fn run_algo
+        *  \brief Runs the algorithm until stopping criteria
+        *  return void
+        */
+        void run_algo() { this->run_iterations(0, shade.iter_max); }
+        /** \fn iterate(const size_t& iter)
+        *  \brief Runs one iteration of the algorithm
+        *  \param iter The iteration
+        *  \return True if the stopping criteria are met
+        */
+        bool iterate(const size_t& iter);
+    };
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<SHADE, T, F, C, N>::sample_parameters(const size_t& i)
+    {
+        std::uniform_int_distribution<size_t> memory_distribution(0, shade.memory_size - 1);
+        const size_t r = memory_distribution(this->generator);
+        std::normal_distribution<T> cr_distribution(memory_cr[r], 0.1);
+        cr[i] = std::clamp(cr_distribution(this->generator), T(0), T(1));
+        //! The scale factor is drawn again until it is positive and truncated to 1
+        std::cauchy_distribution<T> f_distribution(memory_f[r], 0.1);
+        T f = 0;
+        while (!(f > 0))
+        {
+            f = f_distribution(this->generator);
+        }
+        f_param[i] = std::min(f, T(1));
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<SHADE, T, F, C, N>::construct_trial(const size_t& i, const size_t& npbest, std::span<T, N> trial)
+    {
+        const size_t npop = this->individuals.size();
+        std::uniform_int_distribution<size_t> pbest_distribution(0, npbest - 1);
+        std::uniform_int_distribution<size_t> r1_distribution(0, npop - 1);
+        std::uniform_int_distribution<size_t> r2_distribution(0, npop + archive.size() - 1);
+        //! r1 is an individual and r2 an individual or an archived parent, both different from the target and from each other
+        const size_t pbest = order[pbest_distribution(this->generator)];
+        size_t r1 = r1_distribution(this->generator);
+        while (r1 == i)
+        {
+            r1 = r1_distribution(this->generator);
+        }
+        size_t r2 = r2_distribution(this->generator);
+        while (r2 == i || r2 == r1)
+        {
+            r2 = r2_distribution(this->generator);
+        }
+        const auto x = std::as_const(this->individuals)[i];
+        const auto x_pbest = std::as_const(this->individuals)[pbest];
+        const auto x_r1 = std::as_const(this->individuals)[r1];
+        const auto x_r2 = r2 < npop ? std::as_const(this->individuals)[r2] : std::as_const(archive)[r2 - npop];
+        std::uniform_int_distribution<size_t> j_ind_distribution(0, this->dim() - 1);
+        const size_t jrand = j_ind_distribution(this->generator);
+        for (size_t j = 0; j < this->dim(); ++j)
+        {
+            if (this->distribution(this->generator) <= cr[i] || j == jrand)
+            {
+                trial[j] = x[j] + f_param[i] * (x_pbest[j] - x[j]) + f_param[i] * (x_r1[j] - x_r2[j]);
+            }
+            else
+            {
+                trial[j] = x[j];
+            }
+        }
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<SHADE, T, F, C, N>::archive_parent(const size_t& i)
+    {
+        if (archive.size() < archive_capacity(this->individuals.size()))
+        {
+            archive.push_back(this->individuals[i], this->individuals.fitness(i));
+        }
+        else if (archive.size() > 0)
+        {
+            std::uniform_int_distribution<size_t> archive_distribution(0, archive.size() - 1);
+            archive.set(archive_distribution(this->generator), this->individuals[i], this->individuals.fitness(i));
+        }
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<SHADE, T, F, C, N>::update_memory()
+    {
+        if (improvements.empty())
+        {
+            return;
+        }
+        //! The weights are uniform if the improvements cannot be normalised
+        const T total = std::accumulate(improvements.begin(), improvements.end(), T(0));
+        const bool weighted = std::isfinite(total) && total > 0;
+        T mean_cr = 0;
+        T sum_f = 0;
+        T sum_f2 = 0;
+        for (size_t k = 0; k < improvements.size(); ++k)
+        {
+            const T w = weighted ? improvements[k] / total : T(1) / static_cast<T>(improvements.size());
+            mean_cr += w * success_cr[k];
+            sum_f += w * success_f[k];
+            sum_f2 += w * success_f[k] * success_f[k];
+        }
+        memory_cr[memory_position] = mean_cr;
+        memory_f[memory_position] = sum_f2 / sum_f;
+        memory_position = (memory_position + 1) % shade.memory_size;
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    void Solver<SHADE, T, F, C, N>::reduce_population()
+    {
+        const T progress = std::min(static_cast<T>(this->counters.evaluations) / static_cast<T>(evaluation_budget()), T(1));
+        const size_t target = static_cast<size_t>(std::round(static_cast<T>(shade.npop) - progress * static_cast<T>(shade.npop - shade.min_npop)));
+        const size_t npop = std::max(target, shade.min_npop);
+        if (npop < this->individuals.size())
+        {
+            //! The worst individuals are removed, the others keep their order
+            order.resize(this->individuals.size());
+            std::iota(order.begin(), order.end(), 0);
+            const auto by_fitness = [&](const size_t& l, const size_t& r)
+                {
+                    return this->individuals.fitness(l) < this->individuals.fitness(r) || (this->individuals.fitness(l) == this->individuals.fitness(r) && l < r);
+                };
+            std::nth_element(order.begin(), order.begin() + (npop - 1), order.end(), by_fitness);
+            std::sort(order.begin(), order.begin() + npop);
+            survivors.clear();
+            for (size_t k = 0; k < npop; ++k)
+            {
+                survivors.push_back(this->individuals[order[k]], this->individuals.fitness(order[k]));
+            }
+            std::swap(this->individuals, survivors);
+        }
+        //! Random archived parents are removed, the last one takes the place of each
+        while (archive.size() > archive_capacity(this->individuals.size()))
+        {
+            std::uniform_int_distribution<size_t> archive_distribution(0, archive.size() - 1);
+            const size_t k = archive_distribution(this->generator);
+            archive.set(k, std::as_const(archive)[archive.size() - 1], archive.fitness(archive.size() - 1));
+            archive.pop_back();
+        }
+    }
+
+    template<std::floating_point T, typename F, typename C, size_t N>
+    bool Solver<SHADE, T, F, C, N>::iterate(const size_t& iter)
+    {
+        const size_t npop = this->individuals.size();
+        //! The pbest individuals are drawn from the npbest best individuals, which nth_element moves to the front of order
+        const size_t npbest = std::clamp(static_cast<size_t>(std::round(shade.p_best * static_cast<T>(npop))), size_t(2), npop);
+        {
+            Phase_timer phase{ this->counters.selection_time };
+            order.resize(npop);
+            std::iota(order.begin(), order.end(), 0);
+            std::nth_element(order.begin(), order.begin() + (npbest - 1), order.end(), [&](const size_t& l, const size_t& r) { return this->individuals.fitness(l) < this->individuals.fitness(r); });
+        }
+        trials.resize(npop);
+        cr.resize(npop);
+        f_param.resize(npop);
+        for (size_t i = 0; i < npop; ++i)
+        {
+            sample_parameters(i);
+            construct_trial(i, npbest, trials[i]);
+            while (!this->check_constraints(trials[i]))
+            {
+                ++this->counters.resamples;
+                construct_trial(i, npbest, trials[i]);
+            }
+        }
+        this->evaluate_population(trials);
+        {
+            Phase_timer phase{ this->counters.selection_time };
+            success_cr.clear();
+            success_f.clear();
+            improvements.clear();
+            for (size_t i = 0; i < npop; ++i)
+            {
+                if (trials.fitness(i) <= this->individuals.fitness(i))
+                {
+                    //! Only strict improvements adapt the parameters and archive the parent
+                    if (trials.fitness(i) < this->individuals.fitness(i))
+                    {
+                        success_cr.push_back(cr[i]);
+                        success_f.push_back(f_param[i]);
+                        improvements.push_back(this->individuals.fitness(i) - trials.fitness(i));
+                        archive_parent(i);
+                    }
+                    this->individuals.set(i, trials[i], trials.fitness(i));
+                }
+            }
+            update_memory();
+            reduce_population();
+        }
+        //! Recalculate minimum cost individual of the population
+        this->find_min_cost();
+        //! Stopping Criteria
+        this->last_iter = iter;
+        this->record_iteration(iter);
+        if (shade.tol > std::abs(this->min_fitness))
+        {
+            this->solved_flag = true;
+        }
+        return this->solved_flag;
+    }
+}
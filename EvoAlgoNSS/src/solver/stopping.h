@@ -0,0 +1,205 @@
+/** \file stopping.h
+* \author Ioannis Anagnostopoulos
+* \brief Stopping criteria of the solvers, in addition to the tolerance and the maximum number of iterations
+*/
+
+#pragma once
+
+#include <cmath>
+#include <assert.h>
+#include <limits>
+#include <span>
+#include <string_view>
+#include "population.h"
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /** \enum Stop_reason
+    *  \brief Why a solve stopped
+    */
+    enum class Stop_reason { tolerance, max_iterations, deadline, cancelled, stagnation, radius, evaluations, relative_tolerance };
+    /** \fn stop_reason_name(const Stop_reason& reason)
+    *  \param reason The reason a solve stopped
+    *  \return The name of the reason, as printed in the results
+    */
+    constexpr std::string_view stop_reason_name(const Stop_reason& reason)
+    {
+        switch (reason)
+        {
+        case(Stop_reason::tolerance): return "Tolerance";
+        case(Stop_reason::max_iterations): return "Maximum Iterations";
+        case(Stop_reason::deadline): return "Deadline";
+        case(Stop_reason::cancelled): return "Cancelled";
+        case(Stop_reason::stagnation): return "Stagnation";
+        case(Stop_reason::radius): return "Radius";
+        case(Stop_reason::evaluations): return "Evaluations";
+        case(Stop_reason::relative_tolerance): return "Relative Tolerance";
+        }
+        return "";
+    }
+
+    /** \struct Stopping_criteria
+    *  \brief Optional stopping criteria shared by the solvers, a criterion is disabled when its threshold is 0
+    *  \details The enabled criteria are combined: the solve stops at the end of the first iteration that meets any of them.
+    */
+    template<std::floating_point T>
+    struct Stopping_criteria
+    {
+    public:
+        /** \fn Stopping_criteria(const size_t& i_stagnation, const T& i_radius, const size_t& i_max_evaluations, const T& i_relative_tol)
+        *  \brief Constructor
+        *  \param i_stagnation The number of consecutive iterations without improvement of the best fitness after which the solve stops
+        *  \param i_radius The solve stops when every individual is closer than this Euclidean distance to the best solution
+        *  \param i_max_evaluations The number of objective function evaluations after which the solve stops, checked once per iteration
+        *  \param i_relative_tol The solve stops when the fitness of every individual is within this fraction of the absolute best fitness from it
+        *  \return A Stopping_criteria<T> object
+        */
+        Stopping_criteria(const size_t& i_stagnation = 0, const T& i_radius = 0, const size_t& i_max_evaluations = 0, const T& i_relative_tol = 0)
+            : stagnation{ i_stagnation }, radius{ i_radius }, max_evaluations{ i_max_evaluations }, relative_tol{ i_relative_tol }
+        {
+            assert(radius >= 0);
+            assert(relative_tol >= 0);
+        }
+        /** \brief Iterations without improvement after which the solve stops */
+        const size_t stagnation;
+        /** \brief Radius of the population around the best solution below which the solve stops */
+        const T radius;
+        /** \brief Objective function evaluations after which the solve stops */
+        const size_t max_evaluations;
+        /** \brief Relative spread of the fitness of the population below which the solve stops */
+        const T relative_tol;
+        /** \fn enabled() const
+        *  \return Whether any criterion is enabled
+        */
+        bool enabled() const { return stagnation > 0 || radius > 0 || max_evaluations > 0 || relative_tol > 0; }
+    };
+
+    /*! \class Stopping_monitor
+    *  \brief Evaluates the stopping criteria of a solve once per iteration
+    *  \details The criteria are checked from the cheapest to the most expensive. The evaluation budget and the stagnation cost O(1),
+    *  since the monitor keeps the best fitness and the number of iterations since it improved. The relative tolerance and the radius
+    *  scan the population and return as soon as one individual is outside the threshold, so in the usual case of a population that has not
+    *  converged they only look at a few individuals. The distances are compared squared, without square roots.
+    */
+    template<std::floating_point T>
+    class Stopping_monitor
+    {
+    public:
+        /** \fn Stopping_monitor(const Stopping_criteria<T>& i_criteria)
+        *  \brief Constructor
+        *  \param i_criteria The stopping criteria
+        *  \return A Stopping_monitor<T> object
+        */
+        explicit Stopping_monitor(const Stopping_criteria<T>& i_criteria) :
+            criteria{ i_criteria },
+            best{ std::numeric_limits<T>::infinity() },
+            stagnant{ 0 },
+            met_reason{ Stop_reason::max_iterations }
+        {
+        }
+        /** \fn met(const size_t& evaluations, const T& min_fitness, std::span<const T> min_cost, const Population<T, N>& population)
+        *  \brief Updates the state of the criteria at the end of an iteration and checks them
+        *  \param evaluations The number of objective function evaluations so far
+        *  \param min_fitness The fitness of the best solution
+        *  \param min_cost The best solution
+        *  \param population The population at the end of the iteration
+        *  \return True if a criterion is met, which is then given by reason()
+        */
+        template<size_t N>
+        bool met(const size_t& evaluations, const T& min_fitness, std::span<const T> min_cost, const Population<T, N>& population)
+        {
+            if (!criteria.enabled())
+            {
+                return false;
+            }
+            if (criteria.max_evaluations > 0 && evaluations >= criteria.max_evaluations)
+            {
+                return stop(Stop_reason::evaluations);
+            }
+            if (min_fitness < best)
+            {
+                best = min_fitness;
+                stagnant = 0;
+            }
+            else
+            {
+                ++stagnant;
+            }
+            if (criteria.stagnation > 0 && stagnant >= criteria.stagnation)
+            {
+                return stop(Stop_reason::stagnation);
+            }
+            if (criteria.relative_tol > 0 && within_relative_tol(min_fitness, population))
+            {
+                return stop(Stop_reason::relative_tolerance);
+            }
+            if (criteria.radius > 0 && within_radius(min_cost, population))
+            {
+                return stop(Stop_reason::radius);
+            }
+            return false;
+        }
+        /** \fn reason() const
+        *  \return The criterion that was met
+        */
+        Stop_reason reason() const { return met_reason; }
+    private:
+        /** \brief The stopping criteria */
+        const Stopping_criteria<T> criteria;
+        /** \brief Best fitness seen by the monitor */
+        T best;
+        /** \brief Consecutive iterations without improvement of the best fitness */
+        size_t stagnant;
+        /** \brief The criterion that was met */
+        Stop_reason met_reason;
+        /** \fn stop(const Stop_reason& reason)
+        *  \brief Records the criterion that was met
+        *  \param reason The criterion
+        *  \return true
+        */
+        bool stop(const Stop_reason& reason)
+        {
+            met_reason = reason;
+            return true;
+        }
+        /** \fn within_relative_tol(const T& min_fitness, const Population<T, N>& population) const
+        *  \return Whether the fitness of every individual is within the relative tolerance of the best fitness
+        */
+        template<size_t N>
+        bool within_relative_tol(const T& min_fitness, const Population<T, N>& population) const
+        {
+            const T threshold = min_fitness + criteria.relative_tol * std::abs(min_fitness);
+            for (size_t i = 0; i < population.size(); ++i)
+            {
+                if (!(population.fitness(i) <= threshold))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        /** \fn within_radius(std::span<const T> min_cost, const Population<T, N>& population) const
+        *  \return Whether every individual is within the radius of the best solution
+        */
+        template<size_t N>
+        bool within_radius(std::span<const T> min_cost, const Population<T, N>& population) const
+        {
+            const T radius_sq = criteria.radius * criteria.radius;
+            for (size_t i = 0; i < population.size(); ++i)
+            {
+                const auto individual = population[i];
+                T distance_sq = 0;
+                for (size_t j = 0; j < min_cost.size(); ++j)
+                {
+                    distance_sq += (individual[j] - min_cost[j]) * (individual[j] - min_cost[j]);
+                }
+                if (!(distance_sq < radius_sq))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,196 @@
+/** \file thread_pool.h
+* \author Ioannis Anagnostopoulos
+* \brief A minimal thread pool used by the solvers to evaluate populations in parallel
+*/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <exception>
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /*! \class Thread_pool
+    *  \brief A fixed set of worker threads that execute parallel loops
+    *  \details The workers are created once and sleep between loops, so that a solver pays for thread creation once per solve
+    *  and not once per generation. The calling thread takes part in every loop, so a pool of size n starts n - 1 workers
+    *  and a pool of size 1 runs every loop serially without any synchronisation.
+    */
+    class Thread_pool
+    {
+    public:
+        /** \fn Thread_pool(const size_t& i_nthreads)
+        *  \brief Constructor
+        *  \param i_nthreads The number of threads that execute a loop, including the calling thread
+        *  \return A Thread_pool object
+        */
+        explicit Thread_pool(const size_t& i_nthreads) :
+            nthreads{ std::max<size_t>(i_nthreads, 1) },
+            job_size{ 0 },
+            chunk{ 1 },
+            next{ 0 },
+            busy{ 0 },
+            generation{ 0 },
+            stop{ false }
+        {
+            for (size_t i = 1; i < nthreads; ++i)
+            {
+                workers.emplace_back([this]() { work(); });
+            }
+        }
+        Thread_pool(const Thread_pool&) = delete;
+        Thread_pool& operator=(const Thread_pool&) = delete;
+        /** \fn ~Thread_pool()
+        *  \brief Destructor, stops and joins the workers
+        */
+        ~Thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            start.notify_all();
+            for (auto& p : workers)
+            {
+                p.join();
+            }
+        }
+        /** \fn size() const
+        *  \brief Number of threads that execute a loop
+        *  \return The number of threads, including the calling thread
+        */
+        size_t size() const { return nthreads; }
+        /** \fn parallel_for(const size_t& n, Fn&& fn)
+        *  \brief Calls fn(i) for every i in [0, n) and returns when all calls have finished
+        *  \details The calls are distributed over the threads in chunks, fn must be safe to call concurrently for different i.
+        *  If a call throws, no more chunks are started, the loop waits for the chunks being run by the other threads and the first exception
+        *  is rethrown on the calling thread.
+        *  \param n The number of iterations
+        *  \param fn The body of the loop
+        *  \return void
+        */
+        template<typename Fn>
+        void parallel_for(const size_t& n, Fn&& fn)
+        {
+            if (nthreads == 1 || n < 2)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    fn(i);
+                }
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = [&fn](const size_t& i) { fn(i); };
+                job_size = n;
+                chunk = std::max<size_t>(n / (4 * nthreads), 1);
+                next = 0;
+                busy = workers.size();
+                ++generation;
+            }
+            start.notify_all();
+            run_chunks();
+            //! The workers call job, which refers to fn, so the calling thread waits for them even when a call has thrown
+            std::exception_ptr thrown;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [this]() { return busy == 0; });
+                job = nullptr;
+                std::swap(thrown, error);
+            }
+            if (thrown)
+            {
+                std::rethrow_exception(thrown);
+            }
+        }
+    private:
+        /** \brief Number of threads, including the calling thread */
+        const size_t nthreads;
+        /** \brief Worker threads */
+        std::vector<std::thread> workers;
+        /** \brief Protects the state of the current loop */
+        std::mutex mutex;
+        /** \brief Wakes the workers when a loop starts or the pool stops */
+        std::condition_variable start;
+        /** \brief Wakes the calling thread when the workers have finished a loop */
+        std::condition_variable done;
+        /** \brief Body of the current loop */
+        std::function<void(const size_t&)> job;
+        /** \brief Number of iterations of the current loop */
+        size_t job_size;
+        /** \brief Number of iterations taken at once by a thread */
+        size_t chunk;
+        /** \brief Next iteration that has not been taken by a thread */
+        std::atomic<size_t> next;
+        /** \brief Number of workers that have not finished the current loop */
+        size_t busy;
+        /** \brief Counter of the loops, used by the workers to detect a new loop */
+        size_t generation;
+        /** \brief Set when the pool is destroyed */
+        bool stop;
+        /** \brief First exception thrown by a call of the current loop */
+        std::exception_ptr error;
+        /** \fn run_chunks()
+        *  \brief Takes chunks of the current loop until there are none left, an exception is stored and ends the loop for every thread
+        *  \return void
+        */
+        void run_chunks()
+        {
+            try
+            {
+                for (size_t begin = next.fetch_add(chunk); begin < job_size; begin = next.fetch_add(chunk))
+                {
+                    const size_t end = std::min(begin + chunk, job_size);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        job(i);
+                    }
+                }
+            }
+            catch (...)
+            {
+                //! No more chunks are handed out
+                next.store(job_size);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+        /** \fn work()
+        *  \brief Loop of the worker threads
+        *  \return void
+        */
+        void work()
+        {
+            size_t seen = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    start.wait(lock, [&]() { return stop || generation != seen; });
+                    if (stop)
+                    {
+                        return;
+                    }
+                    seen = generation;
+                }
+                run_chunks();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    --busy;
+                }
+                done.notify_one();
+            }
+        }
+    };
+}
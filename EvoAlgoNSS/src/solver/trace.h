@@ -0,0 +1,198 @@
+/** \file trace.h
+* \author Ioannis Anagnostopoulos
+* \brief A per-iteration convergence trace of the solvers, recorded in a preallocated ring buffer
+*/
+
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <concepts>
+#include <algorithm>
+#include <assert.h>
+#include "population.h"
+
+//! Evolutionary Algorithms
+namespace ea
+{
+    /** \struct Trace_record
+    *  \brief The state of a solver at the end of an iteration
+    */
+    template<std::floating_point T>
+    struct Trace_record
+    {
+        /** \brief Iteration, starting from zero */
+        std::uint64_t iteration;
+        /** \brief Number of objective function evaluations so far */
+        std::uint64_t evaluations;
+        /** \brief Fitness of the best solution found so far */
+        T best;
+        /** \brief Mean fitness of the population */
+        T mean;
+        /** \brief Mean Euclidean distance of the individuals from the centroid of the population */
+        T diversity;
+        /** \brief Seconds since the start of the iterations */
+        double elapsed;
+    };
+
+    /*! \class Trace
+    *  \brief Records one Trace_record per iteration of a solver
+    *  \details All the memory is allocated by the constructor, so that recording an iteration neither allocates nor performs I/O.
+    *  When more iterations than the capacity are recorded the oldest records are overwritten, so the trace always holds the last iterations.
+    *  A trace with zero capacity is disabled: it allocates nothing and record() returns after a single comparison.
+    *  The records are exported after the solve, as CSV or as binary. The binary format is the number of records as a std::uint64_t followed by,
+    *  for every record, the iteration and the evaluations as std::uint64_t and the best fitness, the mean fitness, the diversity and the elapsed time
+    *  as double, all in the byte order of the machine.
+    */
+    template<std::floating_point T>
+    class Trace
+    {
+    public:
+        /** \fn Trace(const size_t& i_capacity, const size_t& i_ndv)
+        *  \brief Constructor
+        *  \param i_capacity The maximum number of records kept, zero disables the trace
+        *  \param i_ndv The number of decision variables of the solver
+        *  \return A Trace<T> object
+        */
+        Trace(const size_t& i_capacity, const size_t& i_ndv) :
+            records(i_capacity),
+            centroid(i_capacity > 0 ? i_ndv : 0),
+            head{ 0 },
+            count{ 0 },
+            start{ std::chrono::steady_clock::now() }
+        {
+        }
+        /** \fn enabled() const
+        *  \brief Whether the trace records iterations
+        *  \return True if the capacity is greater than zero
+        */
+        bool enabled() const { return !records.empty(); }
+        /** \fn size() const
+        *  \brief Number of records held
+        *  \return The number of records
+        */
+        size_t size() const { return count; }
+        /** \fn operator[](const size_t& i) const
+        *  \brief Access to a record, from the oldest to the newest
+        *  \param i The index of the record
+        *  \return A reference to the record
+        */
+        const Trace_record<T>& operator[](const size_t& i) const
+        {
+            assert(i < count);
+            return records[(head + i) % records.size()];
+        }
+        /** \fn restart()
+        *  \brief Clears the records and starts the clock of the elapsed time
+        *  \return void
+        */
+        void restart()
+        {
+            head = 0;
+            count = 0;
+            start = std::chrono::steady_clock::now();
+        }
+        /** \fn record(const size_t& iteration, const size_t& evaluations, const T& best, const Population<T, N>& population)
+        *  \brief Records an iteration, the mean fitness and the diversity are computed from the population
+        *  \param iteration The iteration
+        *  \param evaluations The number of objective function evaluations so far
+        *  \param best The fitness of the best solution found so far
+        *  \param population The population at the end of the iteration
+        *  \return void
+        */
+        template<size_t N>
+        void record(const size_t& iteration, const size_t& evaluations, const T& best, const Population<T, N>& population)
+        {
+            if (records.empty())
+            {
+                return;
+            }
+            const size_t npop = population.size();
+            T mean = 0;
+            std::fill(centroid.begin(), centroid.end(), T{ 0 });
+            for (size_t i = 0; i < npop; ++i)
+            {
+                mean += population.fitness(i);
+                const auto individual = population[i];
+                for (size_t j = 0; j < centroid.size(); ++j)
+                {
+                    centroid[j] += individual[j];
+                }
+            }
+            for (auto& p : centroid)
+            {
+                p /= static_cast<T>(npop);
+            }
+            T diversity = 0;
+            for (size_t i = 0; i < npop; ++i)
+            {
+                const auto individual = population[i];
+                T distance = 0;
+                for (size_t j = 0; j < centroid.size(); ++j)
+                {
+                    distance += (individual[j] - centroid[j]) * (individual[j] - centroid[j]);
+                }
+                diversity += std::sqrt(distance);
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            size_t slot = head;
+            if (count < records.size())
+            {
+                slot = (head + count) % records.size();
+                ++count;
+            }
+            else
+            {
+                //! The buffer is full, the oldest record is overwritten and the next one becomes the oldest
+                head = (head + 1) % records.size();
+            }
+            records[slot] = { iteration, evaluations, best, mean / static_cast<T>(npop), diversity / static_cast<T>(npop), elapsed.count() };
+        }
+        /** \fn write_csv(std::ostream& output) const
+        *  \brief Writes the records as CSV with a header line
+        *  \param output The stream the records are written to
+        *  \return void
+        */
+        void write_csv(std::ostream& output) const
+        {
+            output << "Iteration,Evaluations,Best Fitness,Mean Fitness,Diversity,Elapsed Time\n";
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto& r = (*this)[i];
+                output << r.iteration << "," << r.evaluations << "," << r.best << "," << r.mean << "," << r.diversity << "," << r.elapsed << "\n";
+            }
+        }
+        /** \fn write_binary(std::ostream& output) const
+        *  \brief Writes the records in the binary format described above, the stream has to be opened in binary mode
+        *  \param output The stream the records are written to
+        *  \return void
+        */
+        void write_binary(std::ostream& output) const
+        {
+            const std::uint64_t n = count;
+            output.write(reinterpret_cast<const char*>(&n), sizeof(n));
+            for (size_t i = 0; i < count; ++i)
+            {
+                const auto& r = (*this)[i];
+                const double values[4]{ static_cast<double>(r.best), static_cast<double>(r.mean), static_cast<double>(r.diversity), r.elapsed };
+                output.write(reinterpret_cast<const char*>(&r.iteration), sizeof(r.iteration));
+                output.write(reinterpret_cast<const char*>(&r.evaluations), sizeof(r.evaluations));
+                output.write(reinterpret_cast<const char*>(values), sizeof(values));
+            }
+        }
+    private:
+        /** \brief Ring buffer of the records, its size is the capacity */
+        std::vector<Trace_record<T>> records;
+        /** \brief Centroid of the population, reused across iterations */
+        std::vector<T> centroid;
+        /** \brief Position of the oldest record */
+        size_t head;
+        /** \brief Number of records held */
+        size_t count;
+        /** \brief Start of the iterations */
+        std::chrono::time_point<std::chrono::steady_clock> start;
+    };
+}
@@ -28,6 +28,14 @@ namespace utilities {
         tight, /*!< Use tighter constraints */
         none /*!< Ignore constraints*/
     };
+    /** \struct overloaded
+    *  \brief Combines several function objects into a single overload set, for example an objective function with a single and a batch signature
+    */
+    template<typename... Fs>
+    struct overloaded : Fs...
+    {
+        using Fs::operator()...;
+    };
     /** \fn operator<<(std::ostream& stream, const std::vector<T>& vector)
     *  \brief Overload the operator << for printing vectors
     *  \param stream An out stream
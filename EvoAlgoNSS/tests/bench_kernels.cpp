@@ -0,0 +1,292 @@
+/** \file bench_kernels.cpp
+* \author Ioannis Anagnostopoulos
+* \brief Microbenchmarks of the kernels of the models on the bundled data files
+* \details Every kernel is timed in samples of a fixed number of calls, after a number of warmup samples that are discarded.
+* The time per call of every sample is reported as the minimum, the median and the 10th, 90th and 99th percentiles in nanoseconds,
+* as CSV on the standard output. The NSS parameters are drawn uniformly from the tight constraints of NSS and the rates of the
+* internal rate of return uniformly from [0, 0.2], the kernels cycle through them so that their inputs vary from call to call.
+* The quantiles of the Beta distribution of the parent ranks of GA are computed at probabilities drawn uniformly from [0, 1), with the
+* alpha of the examples, by boost and by the table GA samples them from.
+* Before anything else, the Kolmogorov-Smirnov distance between the table and the Beta distribution is checked for several values of alpha.
+* The distances are written to the standard error and the executable returns 1, without running the benchmarks, when one of them exceeds
+* 1 / size of the table. With --check only the check is run, which is registered as a CTest test.
+*
+* Usage: bench_kernels [bond data file] [interest rate data file] [samples] [warmup samples]
+*        bench_kernels --check
+*
+* The default data files are bond_data.txt and interest_rate_data_periods.txt, so the executable has to be run in the same working directory as the data files.
+*/
+
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "../src/model/yield_curve_fitting.h"
+#include "../src/bond/bondhelper.h"
+#include "../src/solver/geneticalgo.h"
+
+/** \struct Summary
+*  \brief Order statistics of the time per call of the samples of a kernel, in nanoseconds
+*/
+struct Summary
+{
+    /** \brief Fastest sample */
+    double min;
+    /** \brief 10th percentile */
+    double p10;
+    /** \brief Median */
+    double median;
+    /** \brief 90th percentile */
+    double p90;
+    /** \brief 99th percentile */
+    double p99;
+};
+
+/** \fn percentile(const std::vector<double>& sorted, const double& p)
+*  \brief Nearest-rank percentile
+*  \param sorted The samples in ascending order
+*  \param p The percentile in [0, 1]
+*  \return The percentile of the samples
+*/
+double percentile(const std::vector<double>& sorted, const double& p)
+{
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/** \fn measure(const size_t& samples, const size_t& warmup, const size_t& calls, const Fn& fn)
+*  \brief Times a kernel
+*  \param samples The number of timed samples
+*  \param warmup The number of samples that are run before the timed ones and discarded
+*  \param calls The number of calls of the kernel made by one call of fn, the times are divided by it
+*  \param fn The benchmarked function
+*  \return The order statistics of the time per call
+*/
+template<typename Fn>
+Summary measure(const size_t& samples, const size_t& warmup, const size_t& calls, const Fn& fn)
+{
+    for (size_t s = 0; s < warmup; ++s)
+    {
+        fn();
+    }
+    std::vector<double> times(samples);
+    for (auto& p : times)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        p = elapsed.count() / static_cast<double>(calls);
+    }
+    std::sort(times.begin(), times.end());
+    return { times.front(), percentile(times, 0.1), percentile(times, 0.5), percentile(times, 0.9), percentile(times, 0.99) };
+}
+
+/** \fn ks_distance(const D& distribution, const ea::Quantile_table<double>& table, const size_t& points)
+*  \brief Kolmogorov-Smirnov distance between the samples of a quantile table and their distribution
+*  \details The table is monotone, so the distance is the largest difference between a probability u and the cumulative distribution function
+*  at the sample of u. It is evaluated at the knots of the table and at equally spaced points between them.
+*  \param distribution The boost::math distribution of the table
+*  \param table The quantile table
+*  \param points The number of points per interval of the table
+*  \return The largest difference found
+*/
+template<typename D>
+double ks_distance(const D& distribution, const ea::Quantile_table<double>& table, const size_t& points)
+{
+    const size_t n = table.size() * points;
+    double distance = 0;
+    for (size_t k = 0; k < n; ++k)
+    {
+        const double u = static_cast<double>(k) / static_cast<double>(n);
+        distance = std::max(distance, std::abs(u - boost::math::cdf(distribution, table(u))));
+    }
+    return distance;
+}
+
+/** \fn beta_quantile_table_accurate()
+*  \brief Checks that the quantile table of the Beta distribution of the GA parent ranks is within 1 / size of the distribution, for alpha
+*  from 1 to 20, and writes the distances to the standard error
+*  \return True if every distance is within the bound
+*/
+bool beta_quantile_table_accurate()
+{
+    bool accurate = true;
+    for (const double alpha : { 1.0, 2.0, 6.0, 20.0 })
+    {
+        const boost::math::beta_distribution<double> distribution{ 1, alpha };
+        const ea::Quantile_table<double> table{ distribution };
+        const double distance = ks_distance(distribution, table, 16);
+        const double bound = 1.0 / static_cast<double>(table.size());
+        std::cerr << "Quantile table of Beta(1, " << alpha << "): Kolmogorov-Smirnov distance " << distance << (distance > bound ? " exceeds " : " within ") << bound << "\n";
+        accurate = accurate && distance <= bound;
+    }
+    return accurate;
+}
+
+/** \fn report(std::string_view kernel, const size_t& calls, const Summary& summary)
+*  \brief Prints a line of the results
+*  \param kernel The name of the kernel
+*  \param calls The number of calls of the kernel per sample
+*  \param summary The order statistics of the kernel
+*  \return void
+*/
+void report(std::string_view kernel, const size_t& calls, const Summary& summary)
+{
+    std::cout << kernel << "," << calls << "," << summary.min << "," << summary.p10 << "," << summary.median << "," << summary.p90 << "," << summary.p99 << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace bond;
+    using namespace yft;
+    //! The table GA samples the parent ranks from has to stay within 1 / size of the Beta distribution
+    if (!beta_quantile_table_accurate())
+    {
+        return 1;
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--check")
+    {
+        return 0;
+    }
+    const std::string bond_filename = argc > 1 ? argv[1] : "bond_data.txt";
+    const std::string ir_filename = argc > 2 ? argv[2] : "interest_rate_data_periods.txt";
+    const size_t samples = argc > 3 ? std::stoul(argv[3]) : 1000;
+    const size_t warmup = argc > 4 ? std::stoul(argv[4]) : 100;
+    const auto ir_vec = read_ir_from_file<double>(ir_filename);
+    const auto bonds = read_bonds_from_file<double>(bond_filename);
+    const Interest_Rate_Helper<double> ir{ ir_vec };
+    BondHelper<double> bh{ bonds, DF_type::exp };
+    //! Inputs of the kernels
+    constexpr size_t ncandidates = 64;
+    std::mt19937_64 generator{ 42 };
+    std::uniform_real_distribution<double> distribution{ 0.0, 1.0 };
+    const std::array<double, 6> lower{ 0.0, -15.0, -30.0, -30.0, 1e-3, 2.5 };
+    const std::array<double, 6> upper{ 15.0, 30.0, 30.0, 30.0, 2.5, 5.5 };
+    std::vector<double> candidates(6 * ncandidates);
+    for (size_t k = 0; k < candidates.size(); ++k)
+    {
+        candidates[k] = lower[k % 6] + (upper[k % 6] - lower[k % 6]) * distribution(generator);
+    }
+    std::vector<double> rates(ncandidates);
+    for (auto& p : rates)
+    {
+        p = 0.2 * distribution(generator);
+    }
+    std::vector<double> probabilities(ncandidates);
+    for (auto& p : probabilities)
+    {
+        p = distribution(generator);
+    }
+    const boost::math::beta_distribution<double> beta{ 1, 6.0 };
+    const ea::Quantile_table<double> beta_quantile{ beta };
+    //! The Macaulay duration is computed at the yield-to-maturity of every bond
+    std::vector<double> yields;
+    for (const auto& p : bonds)
+    {
+        yields.push_back(compute_irr(p.get_price(), p.get_nominal_value(), p.get_cash_flows(), p.get_time_periods(), DF_type::exp, 0.05));
+    }
+    std::vector<double> maturities;
+    for (const auto& p : ir_vec)
+    {
+        maturities.push_back(p.period);
+    }
+    const auto candidate = [&](const size_t& k) { return std::span<const double>(candidates).subspan(6 * (k % ncandidates), 6); };
+    std::vector<double> costs(ncandidates);
+    //! The results are accumulated in a volatile sink, so that the loops cannot be removed by the compiler
+    volatile double sink = 0;
+    std::cout << "Bonds:," << bonds.size() << ",Rates:," << ir_vec.size() << ",Samples:," << samples << ",Warmup:," << warmup << ",SIMD width:," << simd::width << "\n";
+    std::cout << "Kernel,Calls per sample,Minimum (ns),P10 (ns),Median (ns),P90 (ns),P99 (ns)\n";
+    size_t k = 0;
+    report("svensson", maturities.size(), measure(samples, warmup, maturities.size(), [&]()
+        {
+            const auto solution = candidate(k++);
+            double sum = 0;
+            for (const auto& m : maturities)
+            {
+                sum += svensson(solution, m);
+            }
+            sink = sink + sum;
+        }));
+    report("penalty_svensson", ncandidates, measure(samples, warmup, ncandidates, [&]()
+        {
+            double sum = 0;
+            for (size_t i = 0; i < ncandidates; ++i)
+            {
+                sum += penalty_svensson(candidate(i));
+            }
+            sink = sink + sum;
+        }));
+    for (const auto& df_type : { DF_type::frac, DF_type::exp })
+    {
+        const std::string suffix = df_type == DF_type::frac ? " (frac)" : " (exp)";
+        report("compute_discount_factor" + suffix, maturities.size(), measure(samples, warmup, maturities.size(), [&]()
+            {
+                const double r = rates[k++ % ncandidates];
+                double sum = 0;
+                for (const auto& m : maturities)
+                {
+                    sum += compute_discount_factor(r, m, df_type);
+                }
+                sink = sink + sum;
+            }));
+        report("compute_pv" + suffix, bonds.size(), measure(samples, warmup, bonds.size(), [&]()
+            {
+                const double r = rates[k++ % ncandidates];
+                double sum = 0;
+                for (const auto& p : bonds)
+                {
+                    sum += compute_pv(r, p.get_nominal_value(), p.get_cash_flows(), p.get_time_periods(), df_type);
+                }
+                sink = sink + sum;
+            }));
+        report("compute_macaulay_duration" + suffix, bonds.size(), measure(samples, warmup, bonds.size(), [&]()
+            {
+                double sum = 0;
+                for (size_t i = 0; i < bonds.size(); ++i)
+                {
+                    sum += bonds[i].compute_macaulay_duration(yields[i], df_type);
+                }
+                sink = sink + sum;
+            }));
+    }
+    report("fitness_yield_curve_fitting", 1, measure(samples, warmup, 1, [&]()
+        {
+            sink = sink + ir.fitness_yield_curve_fitting(candidate(k++), false);
+        }));
+    report("fitness_yield_curve_fitting (batch)", ncandidates, measure(samples, warmup, ncandidates, [&]()
+        {
+            ir.fitness_yield_curve_fitting(candidates, costs, false);
+            sink = sink + costs[0];
+        }));
+    report("fitness_bond_pricing_prices", 1, measure(samples, warmup, 1, [&]()
+        {
+            sink = sink + bh.fitness_bond_pricing_prices(candidate(k++), false);
+        }));
+    report("fitness_bond_pricing_prices (batch)", ncandidates, measure(samples, warmup, ncandidates, [&]()
+        {
+            bh.fitness_bond_pricing_prices(candidates, costs, false);
+            sink = sink + costs[0];
+        }));
+    report("beta_quantile (boost)", ncandidates, measure(samples, warmup, ncandidates, [&]()
+        {
+            double sum = 0;
+            for (const auto& p : probabilities)
+            {
+                sum += boost::math::quantile(beta, p);
+            }
+            sink = sink + sum;
+        }));
+    report("beta_quantile (table)", ncandidates, measure(samples, warmup, ncandidates, [&]()
+        {
+            double sum = 0;
+            for (const auto& p : probabilities)
+            {
+                sum += beta_quantile(p);
+            }
+            sink = sink + sum;
+        }));
+    return 0;
+}
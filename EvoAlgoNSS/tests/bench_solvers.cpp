@@ -0,0 +1,269 @@
+/** \file bench_solvers.cpp
+* \author Ioannis Anagnostopoulos
+* \brief End-to-end benchmark of the solvers on the Yield Curve Fitting (YFT), Bond Pricing with prices (BPP) and yields (BPY) and
+* Internal Rate of Return (IRR) problems
+* \details Every solver configuration solves every problem once per seed, the seed of run k being derive_seed(seed, k). A run is successful
+* when the fitness of its best solution is below the tolerance of its problem, which are the tolerances of the showcase. An IRR run computes
+* the yield-to-maturity of every bond, its time and evaluations are the sums over the bonds and it is successful when every bond is.
+*
+* Three CSV files are written:
+* - [prefix]-runs.csv, one line per run with its seed, success, fitness, iterations, evaluations and time.
+* - [prefix]-ecdf.csv, the empirical cumulative distribution functions of the time-to-tolerance and of the evaluations-to-tolerance: for every
+* successful run, the fraction of all the runs of its configuration that reached the tolerance within its time or evaluations. The fractions
+* of a configuration end at its success rate.
+* - [prefix]-summary.csv, one line per configuration with its success rate, the median time and evaluations of its successful runs and the expected
+* running time (the time or evaluations of all runs divided by the number of successful runs).
+*
+* Usage: bench_solvers [runs] [output prefix] [bond data file] [interest rate data file]
+*
+* The default data files are bond_data_3.txt and interest_rate_data_periods.txt, so the executable has to be run in the same working directory as the data files.
+*/
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include "../src/bond/bondhelper.h"
+#include "../src/solver/geneticalgo.h"
+#include "../src/solver/pso_sub_swarm.h"
+#include "../src/solver/differentialevo.h"
+#include "../src/solver/shade.h"
+#include "../src/solver/lbestpso.h"
+#include "../src/solver/rootfinder.h"
+
+/** \struct Run
+*  \brief The outcome of a run of a solver configuration on a problem
+*/
+struct Run
+{
+    /** \brief Seed of the run */
+    std::uint64_t seed;
+    /** \brief Whether the fitness reached the tolerance */
+    bool solved;
+    /** \brief Fitness of the best solution */
+    double fitness;
+    /** \brief Iterations of the solver */
+    size_t iterations;
+    /** \brief Objective function evaluations */
+    size_t evaluations;
+    /** \brief Time of the solve in seconds */
+    double time;
+};
+
+/** \struct Configuration
+*  \brief The runs of a solver configuration on a problem
+*/
+struct Configuration
+{
+    /** \brief Name of the problem */
+    std::string problem;
+    /** \brief Name of the solver configuration */
+    std::string algorithm;
+    /** \brief Runs of the configuration */
+    std::vector<Run> runs;
+};
+
+/** \fn solve_once(const F& f, const C& c, const S<T>& solver_struct, const T& target, const std::uint64_t& seed)
+*  \brief Solves a problem once
+*  \param f The objective function
+*  \param c The constraints function
+*  \param solver_struct The parameter structure of the solver, printing to the terminal and to files should be disabled
+*  \param target The tolerance on the fitness that a successful run reaches
+*  \param seed The seed of the run
+*  \return The outcome of the run
+*/
+template<size_t N, typename F, typename C, template<typename> class S, std::floating_point T>
+Run solve_once(const F& f, const C& c, const S<T>& solver_struct, const T& target, const std::uint64_t& seed)
+{
+    const auto result = ea::solve<N>(f, c, solver_struct, "bench", seed);
+    const bool solved = target > std::abs(result.min_fitness);
+    return { seed, solved, result.min_fitness, result.last_iter, result.counters.evaluations, result.elapsed_time };
+}
+
+/** \fn run_configuration(std::string_view problem, std::string_view algorithm, const size_t& runs, const std::uint64_t& seed, const Fn& fn)
+*  \brief Runs a solver configuration on a problem with one seed per run
+*  \param problem The name of the problem
+*  \param algorithm The name of the solver configuration
+*  \param runs The number of runs
+*  \param seed The seed the seeds of the runs are derived from
+*  \param fn A function that takes the seed of a run and returns its outcome
+*  \return The runs of the configuration
+*/
+template<typename Fn>
+Configuration run_configuration(std::string_view problem, std::string_view algorithm, const size_t& runs, const std::uint64_t& seed, const Fn& fn)
+{
+    Configuration configuration{ std::string(problem), std::string(algorithm), {} };
+    for (size_t k = 0; k < runs; ++k)
+    {
+        configuration.runs.push_back(fn(ea::derive_seed(seed, k)));
+    }
+    size_t successes = 0;
+    for (const auto& p : configuration.runs)
+    {
+        successes += p.solved ? 1 : 0;
+    }
+    std::cerr << problem << " " << algorithm << ": " << successes << "/" << runs << " runs reached the tolerance\n";
+    return configuration;
+}
+
+/** \fn median(std::vector<double> x)
+*  \brief The median of some values
+*  \param x The values
+*  \return The median, NaN when there are no values
+*/
+double median(std::vector<double> x)
+{
+    if (x.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    std::sort(x.begin(), x.end());
+    const size_t n = x.size();
+    return n % 2 == 1 ? x[n / 2] : (x[n / 2 - 1] + x[n / 2]) / 2;
+}
+
+/** \fn write_results(const std::vector<Configuration>& configurations, const std::string& prefix)
+*  \brief Writes the runs, the ECDFs and the summary of the configurations to CSV files
+*  \param configurations The configurations
+*  \param prefix The prefix of the names of the files
+*  \return void
+*/
+void write_results(const std::vector<Configuration>& configurations, const std::string& prefix)
+{
+    std::ofstream runs(prefix + "-runs.csv");
+    std::ofstream ecdf(prefix + "-ecdf.csv");
+    std::ofstream summary(prefix + "-summary.csv");
+    runs << "Problem,Algorithm,Run,Seed,Solved,Fitness,Iterations,Evaluations,Time\n";
+    ecdf << "Problem,Algorithm,Measure,Value,Fraction\n";
+    summary << "Problem,Algorithm,Runs,Successes,Success Rate,Median Time,Median Evaluations,Expected Running Time,Expected Running Evaluations\n";
+    for (const auto& p : configurations)
+    {
+        const std::string label = p.problem + "," + p.algorithm + ",";
+        std::vector<double> times;
+        std::vector<double> evaluations;
+        double total_time = 0;
+        double total_evaluations = 0;
+        for (size_t k = 0; k < p.runs.size(); ++k)
+        {
+            const Run& r = p.runs[k];
+            runs << label << k << "," << r.seed << "," << r.solved << "," << r.fitness << "," << r.iterations << "," << r.evaluations << "," << r.time << "\n";
+            total_time += r.time;
+            total_evaluations += static_cast<double>(r.evaluations);
+            if (r.solved)
+            {
+                times.push_back(r.time);
+                evaluations.push_back(static_cast<double>(r.evaluations));
+            }
+        }
+        const double nruns = static_cast<double>(p.runs.size());
+        for (const auto& [measure, values] : { std::pair{ "Time", times }, std::pair{ "Evaluations", evaluations } })
+        {
+            std::vector<double> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            for (size_t k = 0; k < sorted.size(); ++k)
+            {
+                ecdf << label << measure << "," << sorted[k] << "," << static_cast<double>(k + 1) / nruns << "\n";
+            }
+        }
+        const double successes = static_cast<double>(times.size());
+        const double infinity = std::numeric_limits<double>::infinity();
+        summary << label << p.runs.size() << "," << times.size() << "," << successes / nruns << "," << median(times) << "," << median(evaluations) << ","
+            << (successes > 0 ? total_time / successes : infinity) << "," << (successes > 0 ? total_evaluations / successes : infinity) << "\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace yft;
+    using namespace bond;
+    const size_t runs = argc > 1 ? std::stoul(argv[1]) : 10;
+    const std::string prefix = argc > 2 ? argv[2] : "benchmark";
+    const std::string bond_filename = argc > 3 ? argv[3] : "bond_data_3.txt";
+    const std::string ir_filename = argc > 4 ? argv[4] : "interest_rate_data_periods.txt";
+    const std::vector<double> stdev{ 0.7, 0.7, 0.7, 0.7, 0.7, 0.7 };
+    const std::vector<double> stdev_ga{ 0.5, 0.5, 0.5, 0.5, 0.5, 0.5 };
+    const std::vector<double> vmax{ 100000, 100000, 100000, 100000, 100000, 100000 };
+    const double irr_tol = 0.001;
+    const double tol = 0.0001;
+    const double tol_f = 0.001;
+    const Interest_Rate_Helper<double> ir{ read_ir_from_file<double>(ir_filename) };
+    const auto bonds = read_bonds_from_file<double>(bond_filename);
+    BondHelper<double> bh{ bonds, DF_type::exp };
+    //! The yields, the durations and the starting values of NSS are computed as in the showcase, its log is discarded
+    const Root<double> root_irr{ { 0.05 }, 0, 1, 1e-12, 100, false, Constraints_type::normal, false, false };
+    std::stringstream log;
+    std::streambuf* const terminal = std::cout.rdbuf(log.rdbuf());
+    const auto decision_variables = bh.set_init_nss_params(root_irr);
+    std::cout.rdbuf(terminal);
+    //! Solver configurations of the showcase, without printing
+    const DE<double> de_irr{ 1, 0.6, { 0.05 }, { 0.7 }, 10, irr_tol, 500, false, Constraints_type::normal, false, false };
+    //! The adaptive DE has the population and the iterations of the classic DE, so that their evaluations-to-tolerance can be compared
+    const SHADE<double> shade_irr{ 6, 0.11, 2.6, 4, { 0.05 }, { 0.7 }, 10, irr_tol, 500, false, Constraints_type::normal, false, false };
+    const GA<double> ga_irr{ 0.4, 0.35, 6.0, { 0.05 }, { 0.5 }, 42, irr_tol, 2000, false, Constraints_type::normal, Strategy::remove, false, false };
+    const PSOl<double> psol_irr{ 1.49618, 0.9, { 1000000 }, { 0.05 }, { 0.7 }, 22, irr_tol, 3000, false, Constraints_type::normal, false, false };
+    const PSOs<double> psos_irr{ 2.05, 2.05, 2, 0.9, 1.0, { 1000000 }, { 0.05 }, { 0.7 }, 24, irr_tol, 1000, false, Constraints_type::normal, false, false };
+    const Root<double> root{ { 0.05 }, 0, 1, 1e-12, 100, false, Constraints_type::normal, false, false };
+    const auto nss_configurations = [&](const double& nss_tol)
+        {
+            return std::tuple{
+                DE<double>{ 1, 0.6, decision_variables, stdev, 60, nss_tol, 500, false, Constraints_type::tight, false, false },
+                SHADE<double>{ 6, 0.11, 2.6, 4, decision_variables, stdev, 60, nss_tol, 500, false, Constraints_type::tight, false, false },
+                GA<double>{ 0.4, 0.35, 6.0, decision_variables, stdev_ga, 250, nss_tol, 2000, false, Constraints_type::tight, Strategy::remove, false, false },
+                PSOl<double>{ 1.49618, 0.9, vmax, decision_variables, stdev, 130, nss_tol, 3000, false, Constraints_type::tight, false, false },
+                PSOs<double>{ 2.05, 2.05, 6, 0.9, 1.0, vmax, decision_variables, stdev, 24, nss_tol, 1000, false, Constraints_type::tight, false, false } };
+        };
+    const auto constraints_nss = [](const Constraints_type& constraints_type)
+        {
+            return [constraints_type](std::span<const double> solution) { return constraints_svensson(solution, constraints_type); };
+        };
+    std::vector<Configuration> configurations;
+    //! Every NSS problem is solved by every configuration
+    const auto run_nss = [&](std::string_view problem, const auto& f, const double& nss_tol)
+        {
+            std::apply([&](const auto&... solver_struct)
+                {
+                    (configurations.push_back(run_configuration(problem, solver_struct.type, runs, solver_struct.seed, [&](const std::uint64_t& seed)
+                        {
+                            return solve_once<6>(f, constraints_nss(solver_struct.constraints_type), solver_struct, nss_tol, seed);
+                        })), ...);
+                }, nss_configurations(nss_tol));
+        };
+    const auto yft_f = overloaded{
+        [&](std::span<const double> solution) { return ir.fitness_yield_curve_fitting(solution, false); },
+        [&](std::span<const double> candidates, std::span<double> costs) { ir.fitness_yield_curve_fitting(candidates, costs, false); } };
+    run_nss("YFT", yft_f, tol_f);
+    const auto bpp_f = overloaded{
+        [&](std::span<const double> solution) { return bh.fitness_bond_pricing_prices(solution, false); },
+        [&](std::span<const double> candidates, std::span<double> costs) { bh.fitness_bond_pricing_prices(candidates, costs, false); } };
+    run_nss("BPP", bpp_f, tol);
+    const auto bpy_f = overloaded{
+        [&](std::span<const double> solution) { return bh.fitness_bond_pricing_yields(solution, false); },
+        [&](std::span<const double> candidates, std::span<double> costs) { bh.fitness_bond_pricing_yields(candidates, costs, false); } };
+    run_nss("BPY", bpy_f, tol);
+    //! An IRR run computes the yields of all bonds, with a seed per bond
+    std::apply([&](const auto&... solver_struct)
+        {
+            (configurations.push_back(run_configuration("IRR", solver_struct.type, runs, solver_struct.seed, [&](const std::uint64_t& seed)
+                {
+                    Run total{ seed, true, 0, 0, 0, 0 };
+                    for (size_t i = 0; i < bonds.size(); ++i)
+                    {
+                        const auto& p = bonds[i];
+                        const auto f = overloaded{
+                            [&](std::span<const double> solution) { return fitness_irr(solution, p.get_price(), p.get_nominal_value(), p.get_cash_flows(), p.get_time_periods(), DF_type::exp, false); },
+                            [&](const double& r) { return residual_irr(r, p.get_price(), p.get_nominal_value(), p.get_cash_flows(), p.get_time_periods(), DF_type::exp); } };
+                        const auto c = [&](std::span<const double> solution) { return constraints_irr(solution, solver_struct.constraints_type); };
+                        const Run r = solve_once<1>(f, c, solver_struct, irr_tol, ea::derive_seed(seed, i));
+                        total.solved = total.solved && r.solved;
+                        total.fitness = std::max(total.fitness, r.fitness);
+                        total.iterations += r.iterations;
+                        total.evaluations += r.evaluations;
+                        total.time += r.time;
+                    }
+                    return total;
+                })), ...);
+        }, std::tuple{ de_irr, shade_irr, ga_irr, psol_irr, psos_irr, root });
+    write_results(configurations, prefix);
+    return 0;
+}
@@ -0,0 +1,110 @@
+/** \file bench_yield_curve_fitting.cpp
+* \author Ioannis Anagnostopoulos
+* \brief Benchmark of the fitness function of the yield curve fitting problem
+* \details Compares the fitness functions of Interest_Rate_Helper with a reference implementation that loops over an array of Interest_Rate
+* structs and calls svensson(solution, m) for every rate. The candidates are drawn uniformly from the tight constraints of NSS.
+*
+* Usage: bench_yield_curve_fitting [interest rate data file] [number of candidates] [repetitions]
+*
+* The default data file is interest_rate_data_periods.txt, so the executable has to be run in the same working directory as the data files.
+*/
+
+#include <chrono>
+#include <random>
+#include <string>
+#include "../src/model/yield_curve_fitting.h"
+
+/** \fn reference_fitness(const std::vector<yft::Interest_Rate<T>>& ir_vec, std::span<const T> solution)
+*  \brief The fitness function of the yield curve fitting problem as a loop over the interest rates, without the penalty
+*  \param ir_vec The interest rates
+*  \param solution NSS parameters candindate solution
+*  \return The sum of squares of the errors
+*/
+template<std::floating_point T>
+T reference_fitness(const std::vector<yft::Interest_Rate<T>>& ir_vec, std::span<const T> solution)
+{
+    T sum_of_squares = 0;
+    for (size_t i = 0; i < ir_vec.size(); ++i)
+    {
+        T estimate = svensson(solution, ir_vec[i].period);
+        sum_of_squares = sum_of_squares + std::pow(ir_vec[i].rate - estimate, 2);
+    }
+    return sum_of_squares;
+}
+
+/** \fn time_per_candidate(const size_t& candidates, const size_t& repetitions, const Fn& fn)
+*  \brief Times repeated calls of fn
+*  \param candidates The number of candidates evaluated by one call of fn
+*  \param repetitions The number of calls
+*  \param fn The benchmarked function
+*  \return The elapsed time per candidate in nanoseconds
+*/
+template<typename Fn>
+double time_per_candidate(const size_t& candidates, const size_t& repetitions, const Fn& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r)
+    {
+        fn();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(candidates * repetitions);
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace yft;
+    const std::string filename = argc > 1 ? argv[1] : "interest_rate_data_periods.txt";
+    const size_t npop = argc > 2 ? std::stoul(argv[2]) : 256;
+    const size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 2000;
+    const auto ir_vec = read_ir_from_file<double>(filename);
+    const Interest_Rate_Helper<double> ir{ ir_vec };
+    std::mt19937_64 generator{ 42 };
+    std::uniform_real_distribution<double> distribution{ 0.0, 1.0 };
+    const std::array<double, 6> lower{ 0.0, -15.0, -30.0, -30.0, 1e-3, 2.5 };
+    const std::array<double, 6> upper{ 15.0, 30.0, 30.0, 30.0, 2.5, 5.5 };
+    std::vector<double> candidates(6 * npop);
+    for (size_t k = 0; k < candidates.size(); ++k)
+    {
+        candidates[k] = lower[k % 6] + (upper[k % 6] - lower[k % 6]) * distribution(generator);
+    }
+    std::vector<double> reference(npop);
+    std::vector<double> single(npop);
+    std::vector<double> batch(npop);
+    //! The costs are accumulated in a volatile sink, so that the loops cannot be removed by the compiler
+    volatile double sink = 0;
+    const double reference_time = time_per_candidate(npop, repetitions, [&]()
+        {
+            for (size_t k = 0; k < npop; ++k)
+            {
+                reference[k] = reference_fitness<double>(ir_vec, std::span<const double>(candidates).subspan(6 * k, 6));
+            }
+            sink = sink + reference[0];
+        });
+    const double single_time = time_per_candidate(npop, repetitions, [&]()
+        {
+            for (size_t k = 0; k < npop; ++k)
+            {
+                single[k] = ir.fitness_yield_curve_fitting(std::span<const double>(candidates).subspan(6 * k, 6), false);
+            }
+            sink = sink + single[0];
+        });
+    const double batch_time = time_per_candidate(npop, repetitions, [&]()
+        {
+            ir.fitness_yield_curve_fitting(candidates, batch, false);
+            sink = sink + batch[0];
+        });
+    double single_difference = 0;
+    double batch_difference = 0;
+    for (size_t k = 0; k < npop; ++k)
+    {
+        single_difference = std::max(single_difference, std::abs(single[k] - reference[k]) / reference[k]);
+        batch_difference = std::max(batch_difference, std::abs(batch[k] - reference[k]) / reference[k]);
+    }
+    std::cout << "Rates:," << ir_vec.size() << ",Candidates:," << npop << ",Repetitions:," << repetitions << ",SIMD width:," << simd::width << "\n";
+    std::cout << "Fitness,Time per candidate (ns),Speedup,Maximum relative difference\n";
+    std::cout << "Reference," << reference_time << ",1,0\n";
+    std::cout << "Single," << single_time << "," << reference_time / single_time << "," << single_difference << "\n";
+    std::cout << "Batch," << batch_time << "," << reference_time / batch_time << "," << batch_difference << "\n";
+    return 0;
+}
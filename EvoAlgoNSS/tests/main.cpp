@@ -71,6 +71,7 @@
 #include "../src/solver/pso_sub_swarm.h"
 #include "../src/solver/differentialevo.h"
 #include "../src/solver/lbestpso.h"
+#include "../src/solver/rootfinder.h"
 
 int main()
 {
@@ -86,9 +87,9 @@ int main()
     BondHelper<double> de{ read_bonds_from_file<double>("bond_data_3.txt"), DF_type::exp };
     //! IRR solvers
     DE<double> de_irr{ 1, 0.6,{ 0.05 },{ 0.7 }, 10, irr_tol, 500, false, Constraints_type::normal, true, true };
-    DE<double> de_irr_check{ 1, 0.6,{ 0.05 },{ 0.7 }, 10, irr_tol, 500, false, Constraints_type::normal, false, false };
     GA<double> ga_irr{ 0.4, 0.35, 6.0, { 0.05 },{ 0.5 }, 42, irr_tol, 2000, false, Constraints_type::normal, Strategy::remove, true, true };
     PSOl<double> pso_irr{ 1.49618, 0.9, { 1000000 },{ 0.05 },{ 0.7 }, 22, irr_tol, 3000, false, Constraints_type::normal, true, true };
+    Root<double> root_irr{ { 0.05 }, 0, 1, 1e-12, 100, false, Constraints_type::normal, true, true };
     auto decision_variables = de.set_init_nss_params(de_irr);
 
     DE<double> de_pricing{ 1, 0.6, decision_variables, stdev, 60, tol, 500, false, Constraints_type::tight, true, true };
@@ -101,12 +102,13 @@ int main()
     for (size_t i = 0; i < 1; ++i)
     {
         de.set_init_nss_params(pso_irr);
+        de.set_init_nss_params(root_irr);
         de.set_init_nss_params(ga_irr);
-        de.bond_pricing(ga_pricing, de_irr_check, Bond_pricing_type::bpp);
+        de.bond_pricing(ga_pricing, Bond_pricing_type::bpp);
         ir.yieldcurve_fitting(ga_fitting);
-        de.bond_pricing(de_pricing, de_irr_check, Bond_pricing_type::bpp);
+        de.bond_pricing(de_pricing, Bond_pricing_type::bpp);
         ir.yieldcurve_fitting(de_fitting);
-        de.bond_pricing(pso_pricing, de_irr_check, Bond_pricing_type::bpp);
+        de.bond_pricing(pso_pricing, Bond_pricing_type::bpp);
         ir.yieldcurve_fitting(pso_fitting);
     }
     return 0;